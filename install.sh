@@ -204,9 +204,11 @@ function install_plugin() {
     # Copy files
     if $USE_SUDO; then
         sudo cp -v libxfce-launcher.so "$PLUGIN_LIB_DIR/"
+        sudo cp -v xfce-launcher-spawn "$PLUGIN_LIB_DIR/"
         sudo cp -v xfce-launcher.desktop "$PLUGIN_DESKTOP_DIR/"
     else
         cp -v libxfce-launcher.so "$PLUGIN_LIB_DIR/"
+        cp -v xfce-launcher-spawn "$PLUGIN_LIB_DIR/"
         cp -v xfce-launcher.desktop "$PLUGIN_DESKTOP_DIR/"
     fi
     
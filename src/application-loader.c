@@ -14,7 +14,10 @@
  */
 
 #include "xfce-launcher.h"
+#include "catalog-format.h"
+#include <string.h>
 #include <gio/gio.h>
+#include <glib/gstdio.h>
 
 /* Directory paths to monitor */
 static const gchar *desktop_dirs[] = {
@@ -45,6 +48,253 @@ static gchar** get_user_desktop_dirs(void) {
     return (gchar**)g_ptr_array_free(dirs, FALSE);
 }
 
+/* An AppInfo for a parsed .desktop file, taking its reference */
+static AppInfo* new_app_info(GDesktopAppInfo *desktop_info, const gchar *id) {
+    AppInfo *app_info = g_new0(AppInfo, 1);
+    GIcon *gicon = g_app_info_get_icon(G_APP_INFO(desktop_info));
+
+    app_info->name = g_strdup(g_app_info_get_display_name(G_APP_INFO(desktop_info)));
+    app_info->exec = g_strdup(g_app_info_get_commandline(G_APP_INFO(desktop_info)));
+    if (gicon && G_IS_THEMED_ICON(gicon)) {
+        const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
+        if (icon_names && icon_names[0])
+            app_info->icon = g_strdup(icon_names[0]);
+    }
+
+    /* Files loaded by path have no id in GIO, the caller knows it */
+    app_info->id = g_strdup(id ? id : g_app_info_get_id(G_APP_INFO(desktop_info)));
+    app_info->path = g_strdup(g_desktop_app_info_get_filename(desktop_info));
+    app_info->desktop_info = desktop_info;
+    app_info->position = -1;
+
+    return app_info;
+}
+
+/* Map the system catalog, unless it is missing, damaged or older than its directories */
+static GMappedFile* map_system_catalog(void) {
+    const gchar *dirs[] = SYSTEM_CATALOG_DIRS;
+    const CatalogHeader *header;
+    GMappedFile *mapped;
+    GStatBuf st;
+    gsize length;
+    guint i;
+
+    mapped = g_mapped_file_new(SYSTEM_CATALOG_PATH, FALSE, NULL);
+    if (!mapped)
+        return NULL;
+
+    header = (const CatalogHeader *)g_mapped_file_get_contents(mapped);
+    length = g_mapped_file_get_length(mapped);
+    if (length < sizeof(CatalogHeader) || memcmp(header->magic, SYSTEM_CATALOG_MAGIC, 4) != 0 ||
+        header->version != SYSTEM_CATALOG_VERSION || header->strings_size == 0 ||
+        header->strings_offset != sizeof(CatalogHeader) + (guint64)header->n_entries * sizeof(CatalogEntry) ||
+        (guint64)header->strings_offset + header->strings_size != length ||
+        ((const gchar *)header)[length - 1] != '\0') {
+        g_warning("Ignoring damaged system catalog %s", SYSTEM_CATALOG_PATH);
+        g_mapped_file_unref(mapped);
+        return NULL;
+    }
+
+    /* Packages not installed by dpkg do not run the trigger */
+    for (i = 0; dirs[i] != NULL; i++) {
+        if (g_stat(dirs[i], &st) == 0 && st.st_mtime > header->generated) {
+            g_debug("Catalog: %s changed after the system catalog was generated", dirs[i]);
+            g_mapped_file_unref(mapped);
+            return NULL;
+        }
+    }
+
+    return mapped;
+}
+
+/* A string of the catalog, NULL for the empty one or an offset outside the table */
+static const gchar* catalog_string(const gchar *strings, guint32 size, guint32 offset) {
+    if (offset == 0 || offset >= size)
+        return NULL;
+
+    return strings + offset;
+}
+
+/* The Name[locale] matching the user's languages best, as GKeyFile would pick it */
+static const gchar* get_localized_name(const gchar *pairs, const gchar *end, const gchar *name) {
+    const gchar * const *languages = g_get_language_names();
+    guint i;
+
+    for (i = 0; pairs && languages[i] != NULL; i++) {
+        const gchar *locale = pairs;
+
+        while (locale < end && *locale) {
+            const gchar *value = locale + strlen(locale) + 1;
+
+            if (value >= end)
+                break;
+            if (strcmp(locale, languages[i]) == 0)
+                return value;
+            locale = value + strlen(value) + 1;
+        }
+    }
+
+    return name;
+}
+
+static gboolean desktop_list_contains(const gchar *list, const gchar *desktop) {
+    gchar **entries;
+    gboolean found;
+
+    if (!list)
+        return FALSE;
+
+    entries = g_strsplit(list, ";", -1);
+    found = g_strv_contains((const gchar * const *)entries, desktop);
+    g_strfreev(entries);
+
+    return found;
+}
+
+/* OnlyShowIn and NotShowIn against XDG_CURRENT_DESKTOP, the first listed desktop decides */
+static gboolean should_show_in(const gchar *only_show_in, const gchar *not_show_in, gchar **desktops) {
+    guint i;
+
+    for (i = 0; desktops[i] != NULL; i++) {
+        if (desktop_list_contains(only_show_in, desktops[i]))
+            return TRUE;
+        if (desktop_list_contains(not_show_in, desktops[i]))
+            return FALSE;
+    }
+
+    return only_show_in == NULL;
+}
+
+/* An AppInfo whose strings point into the mapped catalog, NULL if it is not shown here */
+static AppInfo* new_mapped_app_info(const CatalogEntry *entry, const gchar *strings, guint32 size,
+                                    gchar **desktops) {
+    const gchar *name = catalog_string(strings, size, entry->name);
+    const gchar *try_exec = catalog_string(strings, size, entry->try_exec);
+    AppInfo *app_info;
+
+    if (!name || (entry->flags & CATALOG_ENTRY_NO_DISPLAY) ||
+        !should_show_in(catalog_string(strings, size, entry->only_show_in),
+                        catalog_string(strings, size, entry->not_show_in), desktops))
+        return NULL;
+
+    if (try_exec) {
+        gchar *program = g_find_program_in_path(try_exec);
+
+        if (!program)
+            return NULL;
+        g_free(program);
+    }
+
+    app_info = g_new0(AppInfo, 1);
+    app_info->name = (gchar *)get_localized_name(catalog_string(strings, size, entry->localized_names),
+                                                 strings + size, name);
+    app_info->exec = (gchar *)catalog_string(strings, size, entry->exec);
+    app_info->icon = (gchar *)catalog_string(strings, size, entry->icon);
+    app_info->id = (gchar *)catalog_string(strings, size, entry->id);
+    app_info->path = (gchar *)catalog_string(strings, size, entry->path);
+    app_info->position = -1;
+    app_info->mapped = TRUE;
+
+    return app_info;
+}
+
+/*
+ * Read a directory of .desktop files into the applications by desktop id,
+ * ids already taken by an earlier layer are skipped. Files that do not
+ * show still take their id, so a user's copy can hide a system entry.
+ */
+static void scan_desktop_directory(GHashTable *by_id, const gchar *dir, const gchar *prefix) {
+    GDir *handle = g_dir_open(dir, 0, NULL);
+    const gchar *filename;
+
+    if (!handle)
+        return;
+
+    while ((filename = g_dir_read_name(handle)) != NULL) {
+        gchar *path = g_build_filename(dir, filename, NULL);
+
+        if (g_file_test(path, G_FILE_TEST_IS_DIR)) {
+            gchar *sub_prefix = g_strconcat(prefix, filename, "-", NULL);
+            scan_desktop_directory(by_id, path, sub_prefix);
+            g_free(sub_prefix);
+        } else if (g_str_has_suffix(filename, ".desktop")) {
+            gchar *id = g_strconcat(prefix, filename, NULL);
+
+            if (!g_hash_table_contains(by_id, id)) {
+                GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(path);
+                AppInfo *app_info = NULL;
+
+                if (desktop_info && !g_desktop_app_info_get_is_hidden(desktop_info) &&
+                    g_app_info_should_show(G_APP_INFO(desktop_info)))
+                    app_info = new_app_info(desktop_info, id);
+                else if (desktop_info)
+                    g_object_unref(desktop_info);
+
+                g_hash_table_insert(by_id, id, app_info);
+            } else {
+                g_free(id);
+            }
+        }
+        g_free(path);
+    }
+
+    g_dir_close(handle);
+}
+
+/*
+ * Applications of the mapped system catalog, overridden by the user's own
+ * .desktop files and completed by data directories the catalog does not
+ * cover. Only the user's directories are read at login.
+ */
+static GList* load_layered_applications(GMappedFile *mapped) {
+    const gchar *catalog_dirs[] = SYSTEM_CATALOG_DIRS;
+    const gchar * const *data_dirs = g_get_system_data_dirs();
+    const CatalogHeader *header = (const CatalogHeader *)g_mapped_file_get_contents(mapped);
+    const CatalogEntry *entries = (const CatalogEntry *)(header + 1);
+    const gchar *strings = (const gchar *)header + header->strings_offset;
+    const gchar *current_desktop = g_getenv("XDG_CURRENT_DESKTOP");
+    GHashTable *by_id = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    GList *app_list = NULL;
+    GHashTableIter iter;
+    AppInfo *app_info;
+    gchar **desktops;
+    gchar *dir;
+    guint i;
+
+    dir = g_build_filename(g_get_user_data_dir(), "applications", NULL);
+    scan_desktop_directory(by_id, dir, "");
+    g_free(dir);
+
+    desktops = g_strsplit(current_desktop ? current_desktop : "", ":", -1);
+    for (i = 0; i < header->n_entries; i++) {
+        const gchar *id = catalog_string(strings, header->strings_size, entries[i].id);
+
+        if (id && !g_hash_table_contains(by_id, id))
+            g_hash_table_insert(by_id, g_strdup(id),
+                                new_mapped_app_info(&entries[i], strings, header->strings_size, desktops));
+    }
+    g_strfreev(desktops);
+
+    /* E.g. the exports Flatpak adds to XDG_DATA_DIRS */
+    for (i = 0; data_dirs[i] != NULL; i++) {
+        dir = g_build_filename(data_dirs[i], "applications", NULL);
+        if (!g_strv_contains((const gchar * const *)catalog_dirs, dir))
+            scan_desktop_directory(by_id, dir, "");
+        g_free(dir);
+    }
+
+    g_hash_table_iter_init(&iter, by_id);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&app_info)) {
+        if (app_info)
+            app_list = g_list_prepend(app_list, app_info);
+    }
+    g_hash_table_destroy(by_id);
+
+    g_debug("Catalog: %u applications mapped from %s", header->n_entries, SYSTEM_CATALOG_PATH);
+
+    return app_list;
+}
+
 /* Load applications from Snap */
 static void load_snap_applications(GList **app_list) {
     const gchar *snap_dir = "/var/lib/snapd/desktop/applications";
@@ -70,20 +320,7 @@ static void load_snap_applications(GList **app_list) {
             GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(desktop_path);
             
             if (desktop_info && g_app_info_should_show(G_APP_INFO(desktop_info))) {
-                AppInfo *app_info = g_new0(AppInfo, 1);
-                app_info->name = g_strdup(g_app_info_get_display_name(G_APP_INFO(desktop_info)));
-                app_info->exec = g_strdup(g_app_info_get_commandline(G_APP_INFO(desktop_info)));
-                
-                GIcon *gicon = g_app_info_get_icon(G_APP_INFO(desktop_info));
-                if (gicon && G_IS_THEMED_ICON(gicon)) {
-                    const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                    if (icon_names && icon_names[0])
-                        app_info->icon = g_strdup(icon_names[0]);
-                }
-                
-                app_info->desktop_info = desktop_info;
-                app_info->position = -1;
-                *app_list = g_list_prepend(*app_list, app_info);
+                *app_list = g_list_prepend(*app_list, new_app_info(desktop_info, filename));
             }
             
             g_free(desktop_path);
@@ -129,20 +366,7 @@ static void load_flatpak_applications(GList **app_list) {
                 GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(desktop_path);
                 
                 if (desktop_info && g_app_info_should_show(G_APP_INFO(desktop_info))) {
-                    AppInfo *app_info = g_new0(AppInfo, 1);
-                    app_info->name = g_strdup(g_app_info_get_display_name(G_APP_INFO(desktop_info)));
-                    app_info->exec = g_strdup(g_app_info_get_commandline(G_APP_INFO(desktop_info)));
-                    
-                    GIcon *gicon = g_app_info_get_icon(G_APP_INFO(desktop_info));
-                    if (gicon && G_IS_THEMED_ICON(gicon)) {
-                        const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                        if (icon_names && icon_names[0])
-                            app_info->icon = g_strdup(icon_names[0]);
-                    }
-                    
-                    app_info->desktop_info = desktop_info;
-                    app_info->position = -1;
-                    *app_list = g_list_prepend(*app_list, app_info);
+                    *app_list = g_list_prepend(*app_list, new_app_info(desktop_info, filename));
                 }
                 
                 g_free(desktop_path);
@@ -166,20 +390,7 @@ static void load_flatpak_applications(GList **app_list) {
                     GDesktopAppInfo *desktop_info = g_desktop_app_info_new_from_filename(desktop_path);
                     
                     if (desktop_info && g_app_info_should_show(G_APP_INFO(desktop_info))) {
-                        AppInfo *app_info = g_new0(AppInfo, 1);
-                        app_info->name = g_strdup(g_app_info_get_display_name(G_APP_INFO(desktop_info)));
-                        app_info->exec = g_strdup(g_app_info_get_commandline(G_APP_INFO(desktop_info)));
-                        
-                        GIcon *gicon = g_app_info_get_icon(G_APP_INFO(desktop_info));
-                        if (gicon && G_IS_THEMED_ICON(gicon)) {
-                            const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                            if (icon_names && icon_names[0])
-                                app_info->icon = g_strdup(icon_names[0]);
-                        }
-                        
-                        app_info->desktop_info = desktop_info;
-                        app_info->position = -1;
-                        *app_list = g_list_prepend(*app_list, app_info);
+                        *app_list = g_list_prepend(*app_list, new_app_info(desktop_info, filename));
                     }
                     
                     g_free(desktop_path);
@@ -192,37 +403,33 @@ static void load_flatpak_applications(GList **app_list) {
     g_free(user_flatpak_dir);
 }
 
-/* Enhanced load_applications function */
-GList* load_applications_enhanced(void) {
+/*
+ * Enhanced load_applications function. With a current system catalog it is
+ * mapped into *system_catalog, which must outlive the returned entries;
+ * otherwise GIO scans every application directory.
+ */
+GList* load_applications_enhanced(GMappedFile **system_catalog) {
     GList *app_list = NULL;
-    GList *apps = g_app_info_get_all();
     GList *iter;
     
-    /* Load standard applications */
-    for (iter = apps; iter != NULL; iter = g_list_next(iter)) {
-        GAppInfo *gapp_info = G_APP_INFO(iter->data);
+    *system_catalog = map_system_catalog();
+    if (*system_catalog) {
+        app_list = load_layered_applications(*system_catalog);
+    } else {
+        GList *apps = g_app_info_get_all();
         
-        if (g_app_info_should_show(gapp_info)) {
-            AppInfo *app_info = g_new0(AppInfo, 1);
-            app_info->name = g_strdup(g_app_info_get_display_name(gapp_info));
-            app_info->exec = g_strdup(g_app_info_get_commandline(gapp_info));
-            
-            GIcon *gicon = g_app_info_get_icon(gapp_info);
-            if (gicon && G_IS_THEMED_ICON(gicon)) {
-                const gchar * const *icon_names = g_themed_icon_get_names(G_THEMED_ICON(gicon));
-                if (icon_names && icon_names[0])
-                    app_info->icon = g_strdup(icon_names[0]);
-            }
+        /* Load standard applications */
+        for (iter = apps; iter != NULL; iter = g_list_next(iter)) {
+            GAppInfo *gapp_info = G_APP_INFO(iter->data);
             
-            app_info->desktop_info = G_DESKTOP_APP_INFO(g_object_ref(gapp_info));
-            app_info->position = -1;
-            
-            app_list = g_list_prepend(app_list, app_info);
+            if (g_app_info_should_show(gapp_info))
+                app_list = g_list_prepend(app_list,
+                                          new_app_info(G_DESKTOP_APP_INFO(g_object_ref(gapp_info)), NULL));
         }
+        
+        g_list_free_full(apps, g_object_unref);
     }
     
-    g_list_free_full(apps, g_object_unref);
-    
     /* Load Snap applications */
     load_snap_applications(&app_list);
     
@@ -261,95 +468,69 @@ static void on_directory_changed(GFileMonitor *monitor,
                                GFile *other_file,
                                GFileMonitorEvent event_type,
                                gpointer user_data) {
-    LauncherPlugin *launcher = (LauncherPlugin *)user_data;
-    
     /* Only refresh on meaningful changes */
     if (event_type == G_FILE_MONITOR_EVENT_CREATED ||
         event_type == G_FILE_MONITOR_EVENT_DELETED ||
         event_type == G_FILE_MONITOR_EVENT_CHANGED) {
         
         gchar *basename = g_file_get_basename(file);
+        gchar *path = g_file_get_path(file);
         
-        /* Only process .desktop files */
-        if (basename && g_str_has_suffix(basename, ".desktop")) {
+        /* Only process .desktop files and a regenerated system catalog */
+        if ((basename && g_str_has_suffix(basename, ".desktop")) ||
+            g_strcmp0(path, SYSTEM_CATALOG_PATH) == 0) {
             g_debug("Application change detected: %s", basename);
             
-            /* Refresh applications list */
-            if (launcher->app_list) {
-                g_list_free_full(launcher->app_list, (GDestroyNotify)free_app_info);
-            }
-            launcher->app_list = load_applications_enhanced();
-            
-            /* Update filtered list */
-            if (launcher->filtered_list) {
-                g_list_free(launcher->filtered_list);
-            }
-            launcher->filtered_list = g_list_copy(launcher->app_list);
-            
-            /* Refresh the UI if overlay is visible */
-            if (launcher->overlay_window && 
-                gtk_widget_get_visible(launcher->overlay_window)) {
-                populate_current_page(launcher);
-                update_page_dots(launcher);
-            }
+            /* Rescan once for every launcher in the process */
+            catalog_schedule_reload();
         }
         
         g_free(basename);
+        g_free(path);
     }
 }
 
-/* Setup directory monitoring */
-void setup_application_monitoring(LauncherPlugin *launcher) {
+static void monitor_directory(GPtrArray *monitors, const gchar *path) {
     GFile *file;
     GFileMonitor *monitor;
     GError *error = NULL;
     
-    /* Monitor system directories */
-    for (int i = 0; desktop_dirs[i] != NULL; i++) {
-        if (g_file_test(desktop_dirs[i], G_FILE_TEST_IS_DIR)) {
-            file = g_file_new_for_path(desktop_dirs[i]);
-            monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, &error);
-            
-            if (monitor) {
-                g_signal_connect(monitor, "changed", 
-                               G_CALLBACK(on_directory_changed), launcher);
-                /* Keep reference to prevent garbage collection */
-                g_object_set_data_full(G_OBJECT(launcher->plugin), 
-                                     g_strdup_printf("monitor-%d", i),
-                                     monitor, g_object_unref);
-            } else if (error) {
-                g_warning("Failed to monitor %s: %s", desktop_dirs[i], error->message);
-                g_error_free(error);
-                error = NULL;
-            }
-            
-            g_object_unref(file);
-        }
+    if (!g_file_test(path, G_FILE_TEST_IS_DIR))
+        return;
+    
+    file = g_file_new_for_path(path);
+    monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, &error);
+    
+    if (monitor) {
+        g_signal_connect(monitor, "changed", 
+                       G_CALLBACK(on_directory_changed), NULL);
+        g_ptr_array_add(monitors, monitor);
+    } else if (error) {
+        g_warning("Failed to monitor %s: %s", path, error->message);
+        g_error_free(error);
     }
     
+    g_object_unref(file);
+}
+
+/* Setup directory monitoring, the monitors are owned by the catalog */
+GPtrArray* setup_application_monitoring(void) {
+    GPtrArray *monitors = g_ptr_array_new_with_free_func(g_object_unref);
+    
+    /* Monitor system directories */
+    for (int i = 0; desktop_dirs[i] != NULL; i++)
+        monitor_directory(monitors, desktop_dirs[i]);
+    
+    /* The packaging regenerates the system catalog after installs */
+    gchar *catalog_dir = g_path_get_dirname(SYSTEM_CATALOG_PATH);
+    monitor_directory(monitors, catalog_dir);
+    g_free(catalog_dir);
+    
     /* Monitor user directories */
     gchar **user_dirs = get_user_desktop_dirs();
-    for (int i = 0; user_dirs[i] != NULL; i++) {
-        if (g_file_test(user_dirs[i], G_FILE_TEST_IS_DIR)) {
-            file = g_file_new_for_path(user_dirs[i]);
-            monitor = g_file_monitor_directory(file, G_FILE_MONITOR_NONE, NULL, &error);
-            
-            if (monitor) {
-                g_signal_connect(monitor, "changed", 
-                               G_CALLBACK(on_directory_changed), launcher);
-                /* Keep reference to prevent garbage collection */
-                g_object_set_data_full(G_OBJECT(launcher->plugin), 
-                                     g_strdup_printf("user-monitor-%d", i),
-                                     monitor, g_object_unref);
-            } else if (error) {
-                g_warning("Failed to monitor %s: %s", user_dirs[i], error->message);
-                g_error_free(error);
-                error = NULL;
-            }
-            
-            g_object_unref(file);
-        }
-        g_free(user_dirs[i]);
-    }
-    g_free(user_dirs);
+    for (int i = 0; user_dirs[i] != NULL; i++)
+        monitor_directory(monitors, user_dirs[i]);
+    g_strfreev(user_dirs);
+    
+    return monitors;
 }
@@ -8,6 +8,9 @@
 
 #include "xfce-launcher.h"
 
+/* Room left between neighbouring positions, a move takes the middle of its new neighbours' */
+#define POSITION_GAP 1024
+
 GList* load_applications(void) {
     GList *app_list = NULL;
     GList *apps = g_app_info_get_all();
@@ -43,37 +46,237 @@ GList* load_applications(void) {
 
 void free_app_info(AppInfo *app_info) {
     if (app_info) {
-        g_free(app_info->name);
-        g_free(app_info->exec);
-        g_free(app_info->icon);
+        /* A launcher's view borrows everything from its catalog entry */
+        if (!app_info->entry) {
+            /* Mapped strings belong to the system catalog */
+            if (!app_info->mapped) {
+                g_free(app_info->name);
+                g_free(app_info->exec);
+                g_free(app_info->icon);
+                g_free(app_info->id);
+                g_free(app_info->path);
+            }
+            if (app_info->desktop_info)
+                g_object_unref(app_info->desktop_info);
+        }
         g_free(app_info->folder_id);
-        if (app_info->desktop_info)
-            g_object_unref(app_info->desktop_info);
         g_free(app_info);
     }
 }
 
-void launch_application(GtkWidget *button, AppInfo *app_info) {
+/*
+ * The GDesktopAppInfo of an application. Apps from the system catalog only
+ * parse their .desktop file when they are launched, and once per process.
+ */
+GDesktopAppInfo* app_info_get_desktop_info(AppInfo *app_info) {
+    if (app_info->entry)
+        return app_info_get_desktop_info(app_info->entry);
+
+    if (!app_info->desktop_info && app_info->path)
+        app_info->desktop_info = g_desktop_app_info_new_from_filename(app_info->path);
+
+    return app_info->desktop_info;
+}
+
+/* Replace the view of the catalog after a rescan, keeping hidden flags, folders and positions */
+void refresh_applications(LauncherPlugin *launcher) {
+    GHashTable *previous = g_hash_table_new(g_str_hash, g_str_equal);
+    GList *apps = catalog_new_view();
+    GList *iter;
+
+    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        if (app->name && !g_hash_table_contains(previous, app->name))
+            g_hash_table_insert(previous, app->name, app);
+    }
+
+    for (iter = apps; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        AppInfo *old = g_hash_table_lookup(previous, app->name);
+
+        if (old) {
+            app->is_hidden = old->is_hidden;
+            app->position = old->position;
+            app->folder_id = old->folder_id;
+            old->folder_id = NULL;
+        }
+    }
+    g_hash_table_destroy(previous);
+
+    for (iter = launcher->folder_list; iter != NULL; iter = g_list_next(iter)) {
+        FolderInfo *folder = (FolderInfo *)iter->data;
+        g_list_free(folder->apps);
+        folder->apps = NULL;
+    }
+
+    /* No drawn grid may keep tiles of the apps freed below, hidden and
+     * standby ones included; they are all rebuilt from the new list */
+    overlay_invalidate_all(launcher);
+    if (launcher->drawn_grid && launcher->app_grid)
+        tile_grid_set_items(launcher->app_grid, NULL, 0);
+
+    g_list_free_full(launcher->app_list, (GDestroyNotify)free_app_info);
+    launcher->app_list = g_list_sort(apps, compare_app_positions);
+    search_invalidate(launcher);
+    folders_join_apps(launcher);
+    launcher->drag_source = NULL;
+
+    /* Update filtered list */
+    g_list_free(launcher->filtered_list);
+    launcher->filtered_list = g_list_copy(launcher->open_folder ? launcher->open_folder->apps :
+                                          launcher->app_list);
+    invalidate_page_index(launcher);
+
+    /* Refresh the UI if overlay is visible, otherwise keep the standby page current */
+    if (launcher->overlay_window && gtk_widget_get_visible(launcher->overlay_window)) {
+        populate_current_page(launcher);
+        update_page_dots(launcher);
+    } else if (launcher->hot_standby) {
+        schedule_standby_rebuild(launcher);
+    }
+}
+
+/* State of a launch still being spawned, outlives the overlay and the app list */
+typedef struct {
+    GAppInfo *app;
+    gchar    *name;
+    gint64   start;
+} PendingLaunch;
+
+static void on_notify_bus_ready(GObject *source, GAsyncResult *result, gpointer data) {
+    GVariant *params = (GVariant *)data;
+    GDBusConnection *connection = g_bus_get_finish(result, NULL);
+
+    if (connection) {
+        /* Fire and forget, nobody waits for the reply */
+        g_dbus_connection_call(connection, "org.freedesktop.Notifications",
+                               "/org/freedesktop/Notifications", "org.freedesktop.Notifications",
+                               "Notify", params, NULL, G_DBUS_CALL_FLAGS_NONE, -1, NULL, NULL, NULL);
+        g_object_unref(connection);
+    } else {
+        g_variant_unref(params);
+    }
+}
+
+/* Tell the user a launch failed without blocking on the notification daemon */
+void notify_launch_error(const gchar *name, const gchar *message) {
+    gchar *summary = g_strdup_printf("Failed to launch %s", name);
+    GVariant *params = g_variant_new("(susssasa{sv}i)", "XFCE Launcher", 0, "dialog-error",
+                                     summary, message, NULL, NULL, -1);
+
+    g_bus_get(G_BUS_TYPE_SESSION, NULL, on_notify_bus_ready, g_variant_ref_sink(params));
+    g_free(summary);
+}
+
+static void pending_launch_free(PendingLaunch *pending) {
+    g_object_unref(pending->app);
+    g_free(pending->name);
+    g_free(pending);
+}
+
+#if GLIB_CHECK_VERSION(2, 60, 0)
+static void on_launch_done(GObject *source, GAsyncResult *result, gpointer data) {
+    PendingLaunch *pending = (PendingLaunch *)data;
     GError *error = NULL;
+
+    if (g_app_info_launch_uris_finish(G_APP_INFO(source), result, &error)) {
+        g_debug("Launch: %s spawned in %.2f ms", pending->name,
+                (g_get_monotonic_time() - pending->start) / 1000.0);
+    } else if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_warning("Failed to launch application: %s", error->message);
+        notify_launch_error(pending->name, error->message);
+    }
+
+    g_clear_error(&error);
+    pending_launch_free(pending);
+}
+#endif
+
+/* Direct launches report their pid and startup id here, for the latency probe */
+static void on_launched(GAppLaunchContext *context, GAppInfo *info, GVariant *platform_data,
+                        LauncherPlugin *launcher) {
+    gint64 *start = g_object_get_data(G_OBJECT(context), "launch-start");
+    const gchar *app_id = g_object_get_data(G_OBJECT(context), "launch-id");
+    const gchar *startup_id = NULL;
+    gint32 pid = 0;
+
+    g_variant_lookup(platform_data, "pid", "i", &pid);
+    g_variant_lookup(platform_data, "startup-notification-id", "&s", &startup_id);
+    probe_launch_started(launcher, app_id, startup_id, pid, start ? *start : 0);
+}
+
+/*
+ * Launch an application. The overlay is hidden before the spawn starts, so
+ * slow wrappers (Flatpak, Snap) never keep it frozen on screen; failures
+ * are reported through a desktop notification instead.
+ */
+void launch_application(GtkWidget *button, AppInfo *app_info) {
     GtkWidget *toplevel = gtk_widget_get_toplevel(button);
     LauncherPlugin *launcher = g_object_get_data(G_OBJECT(toplevel), "launcher");
-    
-    if (app_info && app_info->desktop_info) {
-        g_app_info_launch(G_APP_INFO(app_info->desktop_info), NULL, NULL, &error);
-        if (error) {
+    GdkAppLaunchContext *context;
+    GDesktopAppInfo *desktop_info;
+    PendingLaunch *pending;
+
+    if (!app_info || !(desktop_info = app_info_get_desktop_info(app_info)))
+        return;
+
+    /* Startup notification and focus stealing prevention need the click's timestamp */
+    context = gdk_display_get_app_launch_context(gtk_widget_get_display(button));
+    gdk_app_launch_context_set_timestamp(context, gtk_get_current_event_time());
+
+    pending = g_new0(PendingLaunch, 1);
+    pending->app = G_APP_INFO(g_object_ref(desktop_info));
+    pending->name = g_strdup(app_info->name);
+    pending->start = g_get_monotonic_time();
+
+    if (launcher) {
+        launcher->launch_time = pending->start;
+        hide_overlay(launcher);
+        usage_record_launch(launcher, app_info);
+
+        if (launcher->launch_probe) {
+            gint64 *start = g_new(gint64, 1);
+
+            *start = pending->start;
+            g_object_set_data_full(G_OBJECT(context), "launch-start", start, g_free);
+            g_object_set_data_full(G_OBJECT(context), "launch-id", g_strdup(app_info->id), g_free);
+            g_signal_connect(context, "launched", G_CALLBACK(on_launched), launcher);
+        }
+
+        /* The helper spawns without forking the panel */
+        if (spawn_helper_launch(launcher, desktop_info, app_info->id, G_APP_LAUNCH_CONTEXT(context))) {
+            pending_launch_free(pending);
+            g_object_unref(context);
+            return;
+        }
+    }
+
+#if GLIB_CHECK_VERSION(2, 60, 0)
+    g_app_info_launch_uris_async(pending->app, NULL, G_APP_LAUNCH_CONTEXT(context),
+                                 launcher ? launcher->launch_cancellable : NULL,
+                                 on_launch_done, pending);
+#else
+    {
+        GError *error = NULL;
+
+        if (!g_app_info_launch(pending->app, NULL, G_APP_LAUNCH_CONTEXT(context), &error)) {
             g_warning("Failed to launch application: %s", error->message);
+            notify_launch_error(pending->name, error->message);
             g_error_free(error);
-        } else if (launcher) {
-            hide_overlay(launcher);
         }
+        pending_launch_free(pending);
     }
+#endif
+
+    g_object_unref(context);
 }
 
 void hide_application(AppInfo *app_info, LauncherPlugin *launcher) {
     app_info->is_hidden = TRUE;
+    invalidate_page_index(launcher);
     populate_current_page(launcher);
     update_page_dots(launcher);
-    save_configuration(launcher);
+    journal_record_hide(launcher, app_info);
 }
 
 gint compare_app_names(gconstpointer a, gconstpointer b) {
@@ -86,11 +289,83 @@ gint compare_app_names(gconstpointer a, gconstpointer b) {
     return g_utf8_collate(app_a->name, app_b->name);
 }
 
+/* Apps with a position first in that order, the rest by name */
+gint compare_app_positions(gconstpointer a, gconstpointer b) {
+    const AppInfo *app_a = (const AppInfo *)a;
+    const AppInfo *app_b = (const AppInfo *)b;
+
+    if (app_a->position == -1 && app_b->position == -1)
+        return compare_app_names(a, b);
+    if (app_a->position == -1) return 1;
+    if (app_b->position == -1) return -1;
+    return (app_a->position > app_b->position) - (app_a->position < app_b->position);
+}
+
+/* Number every app in list order, leaving a gap before each */
 void recalculate_positions(LauncherPlugin *launcher) {
     GList *iter;
     gint i = 0;
     for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
         AppInfo *app = (AppInfo *)iter->data;
-        app->position = i++;
+        app->position = ++i * POSITION_GAP;
     }
+    search_invalidate(launcher);
+}
+
+/* Put app right before or after anchor in list, if the list holds both */
+static GList* move_in_list(GList *list, AppInfo *app, AppInfo *anchor, gboolean after) {
+    GList *link;
+
+    if (!g_list_find(list, app) || !g_list_find(list, anchor))
+        return list;
+
+    list = g_list_remove(list, app);
+    link = g_list_find(list, anchor);
+    if (!after)
+        return g_list_insert_before(list, link, app);
+    if (link->next)
+        return g_list_insert_before(list, link->next, app);
+    return g_list_append(list, app);
+}
+
+/*
+ * Move app next to anchor, e.g. after a drop. The app takes a position
+ * between its new neighbours' and only that is journaled; the whole list
+ * is renumbered and saved only once a gap is used up, or when the app
+ * lands among apps that were never placed and are ordered by name.
+ */
+void move_application(LauncherPlugin *launcher, AppInfo *app, AppInfo *anchor, gboolean after) {
+    GList *link;
+    AppInfo *prev, *next;
+    gint low, position = -1;
+
+    launcher->app_list = move_in_list(launcher->app_list, app, anchor, after);
+    launcher->filtered_list = move_in_list(launcher->filtered_list, app, anchor, after);
+    if (launcher->open_folder)
+        launcher->open_folder->apps = move_in_list(launcher->open_folder->apps, app, anchor, after);
+    search_invalidate(launcher);
+
+    link = g_list_find(launcher->app_list, app);
+    prev = link && link->prev ? (AppInfo *)link->prev->data : NULL;
+    next = link && link->next ? (AppInfo *)link->next->data : NULL;
+    low = prev ? prev->position : -1;
+
+    if (prev && prev->position == -1) {
+        /* Unplaced apps have no gaps between them */
+    } else if (!next || next->position == -1) {
+        if (low <= G_MAXINT - POSITION_GAP)
+            position = low < 0 ? POSITION_GAP : low + POSITION_GAP;
+    } else if (next->position - low >= 2) {
+        position = low + (next->position - low) / 2;
+    }
+
+    if (position < 0) {
+        recalculate_positions(launcher);
+        save_configuration(launcher);
+        g_debug("Layout: renumbered %u positions", g_list_length(launcher->app_list));
+        return;
+    }
+
+    app->position = position;
+    journal_record_position(launcher, app);
 }
@@ -0,0 +1,56 @@
+/*
+ * System catalog file format for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#ifndef XFCE_LAUNCHER_CATALOG_FORMAT_H
+#define XFCE_LAUNCHER_CATALOG_FORMAT_H
+
+#include <glib.h>
+
+/*
+ * The system catalog is written by xfce-launcher-index whenever packages
+ * install .desktop files, and mapped read-only by the plugin. It is a
+ * header, an array of fixed size entries and a string table. Strings are
+ * offsets into the table, offset 0 is the empty string. All numbers are
+ * in host byte order, the file never leaves the machine.
+ */
+
+#define SYSTEM_CATALOG_PATH "/var/cache/xfce4/launcher/catalog.bin"
+#define SYSTEM_CATALOG_MAGIC "XLSC"
+#define SYSTEM_CATALOG_VERSION 1
+
+/* Directories indexed, in order of precedence; the plugin scans the rest itself */
+#define SYSTEM_CATALOG_DIRS { "/usr/local/share/applications", "/usr/share/applications", NULL }
+
+/* NoDisplay=true, Hidden entries are left out */
+#define CATALOG_ENTRY_NO_DISPLAY (1 << 0)
+
+typedef struct {
+    gchar   magic[4];
+    guint32 version;
+    guint32 n_entries;
+    guint32 strings_offset;
+    guint32 strings_size;
+    guint32 reserved;
+    gint64  generated;
+} CatalogHeader;
+
+/* localized_names is a run of locale and name strings, ended by an empty locale */
+typedef struct {
+    guint32 id;
+    guint32 name;
+    guint32 localized_names;
+    guint32 exec;
+    guint32 try_exec;
+    guint32 icon;
+    guint32 path;
+    guint32 only_show_in;
+    guint32 not_show_in;
+    guint32 flags;
+} CatalogEntry;
+
+#endif /* XFCE_LAUNCHER_CATALOG_FORMAT_H */
@@ -0,0 +1,314 @@
+/*
+ * Process-wide application catalog for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <stdio.h>
+#include <unistd.h>
+
+/*
+ * Every launcher in the panel process shares one catalog: the scan of the
+ * application directories, their monitors and the decoded icons. Each
+ * launcher holds a view, AppInfos that borrow the catalog's names, icons
+ * and desktop infos and add the launcher's own hidden flags, folders and
+ * positions. A reload hands every launcher a fresh view before the old
+ * entries are freed. Entries from the system catalog point into its
+ * mapping, which lives exactly as long as they do.
+ */
+
+/* Package installs touch several files, rescan once they settle */
+#define CATALOG_RELOAD_DELAY_MS 250
+
+/* Decoded icons of one scale and size */
+typedef struct {
+    guint      refs;
+    GHashTable *icons;
+} IconTier;
+
+/* An inserted icon in the order the cap evicts them, oldest first */
+typedef struct {
+    gpointer        key;
+    gchar           *name;
+    cairo_surface_t *surface;
+    gsize           bytes;
+} IconRecord;
+
+static guint catalog_users = 0;
+static GList *catalog_entries = NULL;
+static GMappedFile *catalog_system = NULL;
+static GList *catalog_launchers = NULL;
+static GPtrArray *catalog_monitors = NULL;
+static GHashTable *catalog_icon_tiers = NULL;
+static guint catalog_reload_source = 0;
+static guint catalog_reload_delay = CATALOG_RELOAD_DELAY_MS;
+static GQueue catalog_icon_records = G_QUEUE_INIT;
+static gsize catalog_icon_bytes = 0;
+static gsize catalog_icon_limit = G_MAXSIZE;
+
+/* Resident set size of the panel process, for the memory reports */
+static gsize get_rss_kib(void) {
+    gchar *contents = NULL;
+    gulong size = 0, resident = 0;
+
+    if (g_file_get_contents("/proc/self/statm", &contents, NULL, NULL)) {
+        sscanf(contents, "%lu %lu", &size, &resident);
+        g_free(contents);
+    }
+
+    return resident * (gsize)sysconf(_SC_PAGESIZE) / 1024;
+}
+
+static void icon_record_free(IconRecord *record) {
+    g_free(record->name);
+    g_free(record);
+}
+
+/* Forget the records of one tier, or of all of them for a NULL key */
+static void purge_icon_records(gpointer key) {
+    GList *link = catalog_icon_records.head;
+
+    while (link != NULL) {
+        GList *next = link->next;
+        IconRecord *record = (IconRecord *)link->data;
+
+        if (!key || record->key == key) {
+            catalog_icon_bytes -= record->bytes;
+            icon_record_free(record);
+            g_queue_delete_link(&catalog_icon_records, link);
+        }
+        link = next;
+    }
+}
+
+/* Forget the record of a surface about to be replaced, its bytes go with it */
+static void drop_icon_record(gpointer key, cairo_surface_t *surface) {
+    GList *link;
+
+    for (link = catalog_icon_records.head; link != NULL; link = link->next) {
+        IconRecord *record = (IconRecord *)link->data;
+
+        if (record->key == key && record->surface == surface) {
+            catalog_icon_bytes -= record->bytes;
+            icon_record_free(record);
+            g_queue_delete_link(&catalog_icon_records, link);
+            return;
+        }
+    }
+}
+
+static void load_entries(void) {
+    gint64 start = g_get_monotonic_time();
+
+    catalog_entries = load_applications_enhanced(&catalog_system);
+    g_debug("Catalog: %u applications scanned in %.2f ms", g_list_length(catalog_entries),
+            (g_get_monotonic_time() - start) / 1000.0);
+}
+
+static void free_entries(GList *entries, GMappedFile *system) {
+    g_list_free_full(entries, (GDestroyNotify)free_app_info);
+    if (system)
+        g_mapped_file_unref(system);
+}
+
+static gboolean on_reload_timeout(gpointer data) {
+    GList *old_entries = catalog_entries;
+    GMappedFile *old_system = catalog_system;
+    GList *iter;
+
+    catalog_reload_source = 0;
+    catalog_system = NULL;
+    load_entries();
+
+    /* The old entries are borrowed until every view is replaced */
+    for (iter = catalog_launchers; iter != NULL; iter = g_list_next(iter))
+        refresh_applications((LauncherPlugin *)iter->data);
+
+    free_entries(old_entries, old_system);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Rescan the application directories shortly, called by the directory monitors */
+void catalog_schedule_reload(void) {
+    if (catalog_users == 0)
+        return;
+
+    if (catalog_reload_source)
+        g_source_remove(catalog_reload_source);
+    catalog_reload_source = g_timeout_add(catalog_reload_delay, on_reload_timeout, NULL);
+}
+
+/* How long the directories must stay quiet before a rescan, 0 rescans on the next idle */
+void catalog_set_reload_delay(guint delay_ms) {
+    catalog_reload_delay = delay_ms;
+}
+
+/* Subscribe a launcher, the first one scans and starts monitoring */
+void catalog_acquire(LauncherPlugin *launcher) {
+    if (catalog_users++ == 0) {
+        load_entries();
+        catalog_monitors = setup_application_monitoring();
+    }
+
+    catalog_launchers = g_list_append(catalog_launchers, launcher);
+    g_debug("Catalog: %u launchers share %u applications, RSS %" G_GSIZE_FORMAT " KiB",
+            catalog_users, g_list_length(catalog_entries), get_rss_kib());
+}
+
+void catalog_release(LauncherPlugin *launcher) {
+    catalog_launchers = g_list_remove(catalog_launchers, launcher);
+
+    if (catalog_users == 0 || --catalog_users > 0)
+        return;
+
+    if (catalog_reload_source) {
+        g_source_remove(catalog_reload_source);
+        catalog_reload_source = 0;
+    }
+    g_clear_pointer(&catalog_monitors, g_ptr_array_unref);
+    free_entries(catalog_entries, catalog_system);
+    catalog_entries = NULL;
+    catalog_system = NULL;
+    purge_icon_records(NULL);
+    g_clear_pointer(&catalog_icon_tiers, g_hash_table_destroy);
+}
+
+/* A launcher's own AppInfos for the catalog entries, in name order */
+GList* catalog_new_view(void) {
+    GList *view = NULL;
+    GList *iter;
+
+    for (iter = catalog_entries; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *entry = (AppInfo *)iter->data;
+        AppInfo *app_info = g_new0(AppInfo, 1);
+
+        app_info->name = entry->name;
+        app_info->exec = entry->exec;
+        app_info->icon = entry->icon;
+        app_info->id = entry->id;
+        app_info->path = entry->path;
+        app_info->position = -1;
+        app_info->entry = entry;
+        view = g_list_prepend(view, app_info);
+    }
+
+    return g_list_reverse(view);
+}
+
+static void icon_tier_free(IconTier *tier) {
+    g_hash_table_destroy(tier->icons);
+    g_free(tier);
+}
+
+/* Icons for a scale and size key, shared by every launcher rendering at it */
+GHashTable* catalog_acquire_icon_tier(gpointer key) {
+    IconTier *tier;
+
+    if (!catalog_icon_tiers)
+        catalog_icon_tiers = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                   (GDestroyNotify)icon_tier_free);
+
+    tier = g_hash_table_lookup(catalog_icon_tiers, key);
+    if (!tier) {
+        tier = g_new0(IconTier, 1);
+        tier->icons = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                            (GDestroyNotify)cairo_surface_destroy);
+        g_hash_table_insert(catalog_icon_tiers, key, tier);
+    }
+    tier->refs++;
+
+    return tier->icons;
+}
+
+void catalog_release_icon_tier(gpointer key) {
+    IconTier *tier = catalog_icon_tiers ? g_hash_table_lookup(catalog_icon_tiers, key) : NULL;
+
+    if (tier && --tier->refs == 0) {
+        purge_icon_records(key);
+        g_hash_table_remove(catalog_icon_tiers, key);
+    }
+}
+
+/* Drop the oldest icons until the cap is met, the newest stays for its caller to paint */
+static void evict_icons(void) {
+    guint evicted = 0;
+
+    while (catalog_icon_bytes > catalog_icon_limit && catalog_icon_records.length > 1) {
+        IconRecord *record = g_queue_pop_head(&catalog_icon_records);
+        IconTier *tier = g_hash_table_lookup(catalog_icon_tiers, record->key);
+
+        /* The icon may have been replaced or cleared since */
+        if (tier && g_hash_table_lookup(tier->icons, record->name) == record->surface) {
+            g_hash_table_remove(tier->icons, record->name);
+            evicted++;
+        }
+        catalog_icon_bytes -= record->bytes;
+        icon_record_free(record);
+    }
+
+    if (evicted > 0)
+        g_debug("Catalog: evicted %u icons, %" G_GSIZE_FORMAT " KiB cached",
+                evicted, catalog_icon_bytes / 1024);
+}
+
+/* Add a decoded icon to the tier of key, the tier takes the surface */
+void catalog_insert_icon(gpointer key, const gchar *name, cairo_surface_t *surface) {
+    IconTier *tier = catalog_icon_tiers ? g_hash_table_lookup(catalog_icon_tiers, key) : NULL;
+    IconRecord *record;
+    cairo_surface_t *previous;
+    gint pixels;
+
+    if (!tier) {
+        cairo_surface_destroy(surface);
+        return;
+    }
+
+    /* A name decoded again replaces its icon, the old bytes are no longer cached */
+    previous = g_hash_table_lookup(tier->icons, name);
+    if (previous)
+        drop_icon_record(key, previous);
+
+    record = g_new0(IconRecord, 1);
+    record->key = key;
+    record->name = g_strdup(name);
+    record->surface = surface;
+
+    /* Surfaces similar to a window live in the X server, count them as their pixels */
+    if (cairo_surface_get_type(surface) == CAIRO_SURFACE_TYPE_IMAGE) {
+        record->bytes = (gsize)cairo_image_surface_get_stride(surface) *
+                        cairo_image_surface_get_height(surface);
+    } else {
+        pixels = (GPOINTER_TO_INT(key) >> 16) * (GPOINTER_TO_INT(key) & 0xffff);
+        record->bytes = (gsize)pixels * pixels * 4;
+    }
+
+    g_hash_table_insert(tier->icons, g_strdup(name), surface);
+    g_queue_push_tail(&catalog_icon_records, record);
+    catalog_icon_bytes += record->bytes;
+    evict_icons();
+}
+
+/* Bytes of decoded icons kept across every tier */
+void catalog_set_icon_cache_limit(gsize bytes) {
+    catalog_icon_limit = bytes;
+    if (catalog_icon_tiers)
+        evict_icons();
+}
+
+/* Drop every decoded icon, e.g. after an icon theme change */
+void catalog_clear_icons(void) {
+    GHashTableIter iter;
+    IconTier *tier;
+
+    purge_icon_records(NULL);
+    if (!catalog_icon_tiers)
+        return;
+
+    g_hash_table_iter_init(&iter, catalog_icon_tiers);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&tier))
+        g_hash_table_remove_all(tier->icons);
+}
@@ -7,60 +7,536 @@
  */
 
 #include "xfce-launcher.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
 
-gchar* get_config_file_path(void) {
+/* Snapshot of one panel plugin instance, each launcher keeps its own layout */
+gchar* get_config_file_path(gint unique_id) {
+    gchar *name = g_strdup_printf("config-%d.xml", unique_id);
+    gchar *path = g_build_filename(g_get_user_config_dir(), "xfce4", "launcher", name, NULL);
+
+    g_free(name);
+    return path;
+}
+
+/* Snapshot shared by all launchers before they had their own, only read */
+static gchar* get_legacy_config_file_path(void) {
     return g_build_filename(g_get_user_config_dir(), "xfce4", "launcher", "config.xml", NULL);
 }
 
-void save_configuration(LauncherPlugin *launcher) {
-    gchar *config_path = get_config_file_path();
-    gchar *config_dir = g_path_get_dirname(config_path);
-    GString *xml;
+/*
+ * Saving is debounced: changes within CONFIG_SAVE_DELAY_MS are written
+ * once. The main thread only copies what is saved into a snapshot; the
+ * XML is built and written by a single writer thread, snapshots in the
+ * order they were taken. The file is replaced by an fsynced temporary
+ * one, so a crash leaves either the old or the new configuration.
+ */
+
+#define CONFIG_SAVE_DELAY_MS 300
+
+typedef struct {
+    gchar *id;
+    gchar *name;
+    gchar *icon;
+} FolderEntry;
+
+typedef struct {
+    gchar    *name;
+    gchar    *folder_id;
+    gboolean hidden;
+    gint     position;
+} AppEntry;
+
+/* What is saved, copied so the writer never touches the live lists */
+typedef struct {
+    LauncherPlugin *launcher;
+    GArray         *folders;
+    GArray         *apps;
+} ConfigSnapshot;
+
+static void folder_entry_clear(FolderEntry *entry) {
+    g_free(entry->id);
+    g_free(entry->name);
+    g_free(entry->icon);
+}
+
+static void app_entry_clear(AppEntry *entry) {
+    g_free(entry->name);
+    g_free(entry->folder_id);
+}
+
+static ConfigSnapshot* take_snapshot(LauncherPlugin *launcher) {
+    ConfigSnapshot *snapshot = g_new0(ConfigSnapshot, 1);
     GList *iter;
-    
-    /* Create config directory if it doesn't exist */
-    g_mkdir_with_parents(config_dir, 0700);
-    
-    /* Build XML content */
-    xml = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+
+    snapshot->launcher = launcher;
+    snapshot->folders = g_array_new(FALSE, FALSE, sizeof(FolderEntry));
+    snapshot->apps = g_array_new(FALSE, FALSE, sizeof(AppEntry));
+    g_array_set_clear_func(snapshot->folders, (GDestroyNotify)folder_entry_clear);
+    g_array_set_clear_func(snapshot->apps, (GDestroyNotify)app_entry_clear);
+
+    for (iter = launcher->folder_list; iter != NULL; iter = g_list_next(iter)) {
+        FolderInfo *folder = (FolderInfo *)iter->data;
+        FolderEntry entry = { g_strdup(folder->id), g_strdup(folder->name), g_strdup(folder->icon) };
+        g_array_append_val(snapshot->folders, entry);
+    }
+
+    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        if (app->is_hidden || app->folder_id || app->position != -1) {
+            AppEntry entry = { g_strdup(app->name), g_strdup(app->folder_id), app->is_hidden, app->position };
+            g_array_append_val(snapshot->apps, entry);
+        }
+    }
+
+    return snapshot;
+}
+
+static void snapshot_free(ConfigSnapshot *snapshot) {
+    g_array_unref(snapshot->folders);
+    g_array_unref(snapshot->apps);
+    g_free(snapshot);
+}
+
+static GString* build_xml(ConfigSnapshot *snapshot) {
+    GString *xml = g_string_new("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    gchar *line;
+    guint i;
+
     g_string_append(xml, "<launcher-config>\n");
-    
+
     /* Save folders */
     g_string_append(xml, "  <folders>\n");
-    for (iter = launcher->folder_list; iter != NULL; iter = g_list_next(iter)) {
-        FolderInfo *folder = (FolderInfo *)iter->data;
-        g_string_append_printf(xml, "    <folder id=\"%s\" name=\"%s\" icon=\"%s\"/>\n",
-                              folder->id, folder->name, folder->icon);
+    for (i = 0; i < snapshot->folders->len; i++) {
+        FolderEntry *folder = &g_array_index(snapshot->folders, FolderEntry, i);
+        line = g_markup_printf_escaped("    <folder id=\"%s\" name=\"%s\" icon=\"%s\"/>\n",
+                                       folder->id, folder->name, folder->icon ? folder->icon : "");
+        g_string_append(xml, line);
+        g_free(line);
     }
     g_string_append(xml, "  </folders>\n");
-    
+
     /* Save app states */
     g_string_append(xml, "  <apps>\n");
-    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
-        AppInfo *app = (AppInfo *)iter->data;
-        if (app->is_hidden || app->folder_id || app->position != -1) {
-            g_string_append_printf(xml, "    <app name=\"%s\" hidden=\"%s\" position=\"%d\"",
-                                  app->name, app->is_hidden ? "true" : "false", app->position);
-            if (app->folder_id) {
-                g_string_append_printf(xml, " folder=\"%s\"", app->folder_id);
-            }
-            g_string_append(xml, "/>\n");
+    for (i = 0; i < snapshot->apps->len; i++) {
+        AppEntry *app = &g_array_index(snapshot->apps, AppEntry, i);
+        line = g_markup_printf_escaped("    <app name=\"%s\" hidden=\"%s\" position=\"%d\"",
+                                       app->name, app->hidden ? "true" : "false", app->position);
+        g_string_append(xml, line);
+        g_free(line);
+        if (app->folder_id) {
+            line = g_markup_printf_escaped(" folder=\"%s\"", app->folder_id);
+            g_string_append(xml, line);
+            g_free(line);
         }
+        g_string_append(xml, "/>\n");
     }
     g_string_append(xml, "  </apps>\n");
     g_string_append(xml, "</launcher-config>\n");
-    
-    /* Write to file */
-    g_file_set_contents(config_path, xml->str, xml->len, NULL);
-    
+
+    return xml;
+}
+
+/* Write to a temporary file, fsync it and rename it over path */
+static gboolean write_atomically(const gchar *path, const gchar *data, gsize length) {
+    gchar *tmp_path = g_strdup_printf("%s.XXXXXX", path);
+    gchar *dir = g_path_get_dirname(path);
+    gsize written = 0;
+    gint fd, dir_fd, saved_errno;
+
+    g_mkdir_with_parents(dir, 0700);
+
+    fd = g_mkstemp(tmp_path);
+    if (fd < 0)
+        goto fail;
+
+    while (written < length) {
+        gssize n = write(fd, data + written, length - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0) {
+            close(fd);
+            goto fail_unlink;
+        }
+        written += n;
+    }
+
+    if (fsync(fd) != 0 || close(fd) != 0 || rename(tmp_path, path) != 0)
+        goto fail_unlink;
+
+    /* Make the rename itself durable */
+    dir_fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd >= 0) {
+        fsync(dir_fd);
+        close(dir_fd);
+    }
+
+    g_free(dir);
+    g_free(tmp_path);
+    return TRUE;
+
+fail_unlink:
+    saved_errno = errno;
+    g_unlink(tmp_path);
+    errno = saved_errno;
+fail:
+    g_warning("Failed to save config file %s: %s", path, g_strerror(errno));
+    g_free(dir);
+    g_free(tmp_path);
+    return FALSE;
+}
+
+/* A snapshot to write, or a line to append to the journal */
+typedef struct {
+    LauncherPlugin *launcher;
+    ConfigSnapshot *snapshot;
+    gchar          *journal_line;
+} ConfigJob;
+
+static void append_journal(const gchar *journal_path, const gchar *line) {
+    gsize length = strlen(line);
+    gint fd;
+
+    /* One write per operation, a crash leaves at most a torn last line */
+    fd = open(journal_path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0 || write(fd, line, length) != (gssize)length)
+        g_warning("Failed to append to %s: %s", journal_path, g_strerror(errno));
+    if (fd >= 0)
+        close(fd);
+}
+
+/* Runs on the writer thread */
+static void write_config_job(gpointer data, gpointer user_data) {
+    ConfigJob *job = (ConfigJob *)data;
+    LauncherPlugin *launcher = job->launcher;
+    gint64 start = g_get_monotonic_time();
+    GString *xml;
+    gboolean saved;
+
+    if (job->journal_line) {
+        append_journal(launcher->journal_path, job->journal_line);
+
+        g_mutex_lock(&launcher->config_lock);
+        perf_counter_add(&launcher->config_journal_time, g_get_monotonic_time() - start);
+        g_mutex_unlock(&launcher->config_lock);
+
+        g_free(job->journal_line);
+        g_free(job);
+        return;
+    }
+
+    xml = build_xml(job->snapshot);
+    saved = write_atomically(launcher->config_path, xml->str, xml->len);
+
+    /* Everything this launcher journaled so far is in the snapshot. Should a
+     * crash keep the journal, its operations are applied once more to their
+     * own result */
+    if (saved)
+        g_unlink(launcher->journal_path);
+
+    g_mutex_lock(&launcher->config_lock);
+    if (saved)
+        perf_counter_add(&launcher->config_write_time, g_get_monotonic_time() - start);
+    else
+        launcher->config_write_failures++;
+    g_mutex_unlock(&launcher->config_lock);
+
     g_string_free(xml, TRUE);
-    g_free(config_dir);
-    g_free(config_path);
+    snapshot_free(job->snapshot);
+    g_free(job);
+}
+
+static void queue_job(LauncherPlugin *launcher, ConfigSnapshot *snapshot, gchar *journal_line) {
+    ConfigJob *job = g_new0(ConfigJob, 1);
+
+    if (!launcher->config_pool)
+        launcher->config_pool = g_thread_pool_new(write_config_job, NULL, 1, FALSE, NULL);
+
+    job->launcher = launcher;
+    job->snapshot = snapshot;
+    job->journal_line = journal_line;
+    g_thread_pool_push(launcher->config_pool, job, NULL);
+}
+
+static void queue_snapshot(LauncherPlugin *launcher) {
+    gint64 start = g_get_monotonic_time();
+
+    queue_job(launcher, take_snapshot(launcher), NULL);
+    launcher->journal_ops = 0;
+    perf_counter_add(&launcher->config_snapshot_time, g_get_monotonic_time() - start);
+}
+
+static gboolean on_save_timeout(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+
+    launcher->config_save_source = 0;
+    queue_snapshot(launcher);
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Schedule a save, the changes of the next CONFIG_SAVE_DELAY_MS are saved with it */
+void save_configuration(LauncherPlugin *launcher) {
+    launcher->config_save_requests++;
+
+    if (!launcher->config_save_source)
+        launcher->config_save_source = g_timeout_add(CONFIG_SAVE_DELAY_MS, on_save_timeout, launcher);
+}
+
+/* Write a pending save now and wait for the writer, called before the lists are freed */
+void flush_configuration(LauncherPlugin *launcher) {
+    if (launcher->config_save_source) {
+        g_source_remove(launcher->config_save_source);
+        launcher->config_save_source = 0;
+        queue_snapshot(launcher);
+    }
+
+    if (launcher->config_pool) {
+        g_thread_pool_free(launcher->config_pool, FALSE, TRUE);
+        launcher->config_pool = NULL;
+    }
+
+    perf_report_configuration(launcher);
+}
+
+/*
+ * Layout changes are journaled: each one appends a line to the journal
+ * of the launcher, and its snapshot in config-<id>.xml is only rewritten
+ * once JOURNAL_COMPACT_OPS lines have piled up. Launchers share neither,
+ * so compacting one never touches the layout of another. A line is an
+ * operation and its tab separated arguments, each escaped with
+ * g_strescape():
+ *
+ *   hide           app name
+ *   position       app name, its new position key
+ *   move           app name, index in the app list, only replayed
+ *   folder-add     folder id, name, icon
+ *   folder-app     app name, folder id or nothing to take it out
+ *   folder-rename  folder id, name
+ *   folder-remove  folder id
+ *
+ * Replaying an operation twice has the same result as once.
+ */
+
+#define JOURNAL_COMPACT_OPS 256
+
+/* Journal of one panel plugin instance */
+gchar* get_journal_file_path(gint unique_id) {
+    gchar *name = g_strdup_printf("config-%d.journal", unique_id);
+    gchar *path = g_build_filename(g_get_user_config_dir(), "xfce4", "launcher", name, NULL);
+
+    g_free(name);
+    return path;
+}
+
+/* Queue one operation, its arguments end with NULL */
+static void journal_append(LauncherPlugin *launcher, const gchar *op, ...) {
+    GString *line = g_string_new(op);
+    const gchar *arg;
+    va_list args;
+
+    va_start(args, op);
+    while ((arg = va_arg(args, const gchar *)) != NULL) {
+        gchar *escaped = g_strescape(arg, NULL);
+        g_string_append_c(line, '\t');
+        g_string_append(line, escaped);
+        g_free(escaped);
+    }
+    va_end(args);
+    g_string_append_c(line, '\n');
+
+    queue_job(launcher, NULL, g_string_free(line, FALSE));
+
+    if (++launcher->journal_ops >= JOURNAL_COMPACT_OPS)
+        save_configuration(launcher);
+}
+
+void journal_record_hide(LauncherPlugin *launcher, AppInfo *app) {
+    journal_append(launcher, "hide", app->name, NULL);
+}
+
+void journal_record_position(LauncherPlugin *launcher, AppInfo *app) {
+    gchar *position = g_strdup_printf("%d", app->position);
+
+    journal_append(launcher, "position", app->name, position, NULL);
+    g_free(position);
+}
+
+void journal_record_folder_add(LauncherPlugin *launcher, FolderInfo *folder) {
+    journal_append(launcher, "folder-add", folder->id, folder->name, folder->icon ? folder->icon : "", NULL);
+}
+
+void journal_record_folder_app(LauncherPlugin *launcher, AppInfo *app) {
+    journal_append(launcher, "folder-app", app->name, app->folder_id ? app->folder_id : "", NULL);
+}
+
+void journal_record_folder_rename(LauncherPlugin *launcher, FolderInfo *folder) {
+    journal_append(launcher, "folder-rename", folder->id, folder->name, NULL);
+}
+
+void journal_record_folder_remove(LauncherPlugin *launcher, FolderInfo *folder) {
+    journal_append(launcher, "folder-remove", folder->id, NULL);
+}
+
+/* Returns TRUE when the operation changed the order of the app list */
+static gboolean replay_operation(LauncherPlugin *launcher, GHashTable *apps, gchar **fields, guint count) {
+    const gchar *op = fields[0];
+    AppInfo *app = NULL;
+    FolderInfo *folder;
+
+    if (count >= 2 && (strcmp(op, "hide") == 0 || strcmp(op, "position") == 0 ||
+                       strcmp(op, "move") == 0 || strcmp(op, "folder-app") == 0)) {
+        app = g_hash_table_lookup(apps, fields[1]);
+        /* The app was uninstalled since */
+        if (!app)
+            return FALSE;
+    }
+
+    if (strcmp(op, "hide") == 0 && count >= 2) {
+        app->is_hidden = TRUE;
+    } else if (strcmp(op, "position") == 0 && count >= 3) {
+        app->position = atoi(fields[2]);
+        return TRUE;
+    } else if (strcmp(op, "move") == 0 && count >= 3) {
+        /* Journals of earlier versions, positions follow the order as after their drops */
+        launcher->app_list = g_list_remove(launcher->app_list, app);
+        launcher->app_list = g_list_insert(launcher->app_list, app, atoi(fields[2]));
+        recalculate_positions(launcher);
+        return TRUE;
+    } else if (strcmp(op, "folder-add") == 0 && count >= 4) {
+        if (find_folder_by_id(launcher, fields[1]))
+            return FALSE;
+        folder = create_folder(fields[2]);
+        g_free(folder->id);
+        folder->id = g_strdup(fields[1]);
+        if (*fields[3]) {
+            g_free(folder->icon);
+            folder->icon = g_strdup(fields[3]);
+        }
+        launcher->folder_list = g_list_append(launcher->folder_list, folder);
+    } else if (strcmp(op, "folder-app") == 0 && count >= 3) {
+        g_free(app->folder_id);
+        app->folder_id = *fields[2] ? g_strdup(fields[2]) : NULL;
+    } else if (strcmp(op, "folder-rename") == 0 && count >= 3) {
+        folder = find_folder_by_id(launcher, fields[1]);
+        if (folder) {
+            g_free(folder->name);
+            folder->name = g_strdup(fields[2]);
+        }
+    } else if (strcmp(op, "folder-remove") == 0 && count >= 2) {
+        /* Its apps are let go when folders are joined after the replay */
+        folder = find_folder_by_id(launcher, fields[1]);
+        if (folder) {
+            launcher->folder_list = g_list_remove(launcher->folder_list, folder);
+            free_folder_info(folder);
+        }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Loading is split in two. parse_configuration() reads the snapshot and the
+ * journal into a ParsedConfig without touching the launcher, so it can run
+ * on a thread while the catalog is scanned. apply_configuration() then
+ * joins it with the app list in one pass over the apps.
+ */
+
+/* What the snapshot says about one app */
+typedef struct {
+    gboolean hidden;
+    gint     position;
+    gchar    *folder_id;
+    gboolean applied;
+} AppEntryState;
+
+struct _ParsedConfig {
+    GHashTable *apps;
+    GList      *folders;
+    GPtrArray  *journal;
+    gint64     parse_us;
+};
+
+static void app_state_free(AppEntryState *state) {
+    g_free(state->folder_id);
+    g_free(state);
+}
+
+static void parsed_config_free(ParsedConfig *config) {
+    g_hash_table_destroy(config->apps);
+    g_list_free_full(config->folders, (GDestroyNotify)free_folder_info);
+    g_ptr_array_unref(config->journal);
+    g_free(config);
+}
+
+/* Split the journal into the fields of its operations */
+static void parse_journal(ParsedConfig *config, const gchar *journal_path) {
+    gchar *contents = NULL;
+    gchar **lines;
+    guint i;
+
+    if (!g_file_get_contents(journal_path, &contents, NULL, NULL))
+        return;
+
+    /* The part after the last newline is empty, or a line torn by a crash */
+    lines = g_strsplit(contents, "\n", -1);
+    for (i = 0; lines[i] && lines[i + 1]; i++) {
+        gchar **fields = g_strsplit(lines[i], "\t", -1);
+        guint count = g_strv_length(fields), j;
+
+        for (j = 1; j < count; j++) {
+            gchar *field = g_strcompress(fields[j]);
+            g_free(fields[j]);
+            fields[j] = field;
+        }
+        g_ptr_array_add(config->journal, fields);
+    }
+
+    g_strfreev(lines);
+    g_free(contents);
+}
+
+/* Apply the journal on top of the loaded snapshot */
+static void replay_journal(LauncherPlugin *launcher, ParsedConfig *config) {
+    GHashTable *apps;
+    GList *iter;
+    gboolean reordered = FALSE;
+    guint i;
+
+    if (config->journal->len == 0)
+        return;
+
+    apps = g_hash_table_new(g_str_hash, g_str_equal);
+    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        if (app->name)
+            g_hash_table_insert(apps, app->name, app);
+    }
+
+    for (i = 0; i < config->journal->len; i++) {
+        gchar **fields = g_ptr_array_index(config->journal, i);
+        guint count = g_strv_length(fields);
+
+        if (count > 0 && replay_operation(launcher, apps, fields, count))
+            reordered = TRUE;
+    }
+
+    /* The order follows the positions, as after a drop */
+    if (reordered) {
+        launcher->app_list = g_list_sort(launcher->app_list, compare_app_positions);
+        search_invalidate(launcher);
+    }
+
+    g_hash_table_destroy(apps);
 }
 
 /* User data for GMarkup parser */
 typedef struct {
-    LauncherPlugin *launcher;
+    ParsedConfig *config;
     gboolean in_folders;
     gboolean in_apps;
 } ParserData;
@@ -89,11 +565,11 @@ static void start_element(GMarkupParseContext *context,
             FolderInfo *folder = create_folder(name);
             g_free(folder->id);
             folder->id = g_strdup(id);
-            if (icon) {
+            if (icon && *icon) {
                 g_free(folder->icon);
                 folder->icon = g_strdup(icon);
             }
-            data->launcher->folder_list = g_list_append(data->launcher->folder_list, folder);
+            data->config->folders = g_list_append(data->config->folders, folder);
         }
     } else if (strcmp(element_name, "app") == 0 && data->in_apps) {
         const gchar *name = NULL, *hidden = NULL, *folder = NULL, *position = NULL;
@@ -105,16 +581,11 @@ static void start_element(GMarkupParseContext *context,
         }
 
         if (name) {
-            GList *iter;
-            for (iter = data->launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
-                AppInfo *app = (AppInfo *)iter->data;
-                if (strcmp(app->name, name) == 0) {
-                    if (hidden && strcmp(hidden, "true") == 0) app->is_hidden = TRUE;
-                    if (folder) app->folder_id = g_strdup(folder);
-                    if (position) app->position = atoi(position);
-                    break;
-                }
-            }
+            AppEntryState *state = g_new0(AppEntryState, 1);
+            state->hidden = hidden && strcmp(hidden, "true") == 0;
+            state->folder_id = g_strdup(folder);
+            state->position = position ? atoi(position) : -1;
+            g_hash_table_replace(data->config->apps, g_strdup(name), state);
         }
     }
 }
@@ -131,54 +602,114 @@ static void end_element(GMarkupParseContext *context,
     }
 }
 
-static gint sort_apps_by_position(gconstpointer a, gconstpointer b) {
-    const AppInfo *app_a = *(const AppInfo **)a;
-    const AppInfo *app_b = *(const AppInfo **)b;
-
-    if (app_a->position == -1 && app_b->position == -1) {
-        return g_utf8_collate(app_a->name, app_b->name);
-    }
-    if (app_a->position == -1) return 1;
-    if (app_b->position == -1) return -1;
-    return app_a->position - app_b->position;
-}
-
-
-void load_configuration(LauncherPlugin *launcher) {
-    gchar *config_path = get_config_file_path();
+/* Read a snapshot and a journal, safe to call from any thread */
+ParsedConfig* parse_configuration(const gchar *snapshot_path, const gchar *journal_path) {
+    ParsedConfig *config = g_new0(ParsedConfig, 1);
+    gint64 start = g_get_monotonic_time();
+    gchar *config_path = g_strdup(snapshot_path);
     gchar *contents = NULL;
     gsize length;
     GError *error = NULL;
 
-    if (!g_file_get_contents(config_path, &contents, &length, &error)) {
-        if (error) {
-            g_warning("Failed to read config file: %s", error->message);
-            g_error_free(error);
-        }
+    config->apps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)app_state_free);
+    config->journal = g_ptr_array_new_with_free_func((GDestroyNotify)g_strfreev);
+
+    /* A launcher that never saved starts from the layout all launchers shared */
+    if (!g_file_test(config_path, G_FILE_TEST_EXISTS)) {
         g_free(config_path);
-        return;
+        config_path = get_legacy_config_file_path();
     }
 
-    ParserData data = { .launcher = launcher, .in_folders = FALSE, .in_apps = FALSE };
-    GMarkupParser parser = {
-        .start_element = start_element,
-        .end_element = end_element,
-        .text = NULL,
-        .passthrough = NULL,
-        .error = NULL
-    };
-
-    GMarkupParseContext *context = g_markup_parse_context_new(&parser, 0, &data, NULL);
-    if (!g_markup_parse_context_parse(context, contents, length, &error)) {
+    /* Without a snapshot the journal may still hold the first changes */
+    if (!g_file_get_contents(config_path, &contents, &length, &error)) {
         if (error) {
-            g_warning("Failed to parse config file: %s", error->message);
+            if (!g_error_matches(error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+                g_warning("Failed to read config file: %s", error->message);
             g_error_free(error);
         }
+    } else {
+        ParserData data = { .config = config, .in_folders = FALSE, .in_apps = FALSE };
+        GMarkupParser parser = {
+            .start_element = start_element,
+            .end_element = end_element,
+            .text = NULL,
+            .passthrough = NULL,
+            .error = NULL
+        };
+
+        GMarkupParseContext *context = g_markup_parse_context_new(&parser, 0, &data, NULL);
+        if (!g_markup_parse_context_parse(context, contents, length, &error)) {
+            if (error) {
+                g_warning("Failed to parse config file: %s", error->message);
+                g_error_free(error);
+            }
+        }
+
+        g_markup_parse_context_free(context);
+        g_free(contents);
     }
-    
-    g_markup_parse_context_free(context);
-    g_free(contents);
     g_free(config_path);
 
-    launcher->app_list = g_list_sort(launcher->app_list, (GCompareFunc)sort_apps_by_position);
+    parse_journal(config, journal_path);
+    config->parse_us = g_get_monotonic_time() - start;
+
+    return config;
+}
+
+/* Join a parsed configuration with the app list, takes ownership of config */
+void apply_configuration(LauncherPlugin *launcher, ParsedConfig *config) {
+    gint64 start = g_get_monotonic_time();
+    GList *iter;
+
+    launcher->folder_list = g_list_concat(launcher->folder_list, config->folders);
+    config->folders = NULL;
+
+    /* An entry belongs to the first app of its name */
+    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        AppEntryState *state = app->name ? g_hash_table_lookup(config->apps, app->name) : NULL;
+
+        if (!state || state->applied)
+            continue;
+
+        if (state->hidden) app->is_hidden = TRUE;
+        if (state->folder_id) app->folder_id = g_strdup(state->folder_id);
+        if (state->position != -1) app->position = state->position;
+        state->applied = TRUE;
+    }
+
+    launcher->app_list = g_list_sort(launcher->app_list, compare_app_positions);
+    search_invalidate(launcher);
+
+    replay_journal(launcher, config);
+    folders_join_apps(launcher);
+
+    launcher->journal_ops = config->journal->len;
+    if (launcher->journal_ops >= JOURNAL_COMPACT_OPS)
+        save_configuration(launcher);
+
+    g_debug("Config: parsed in %.2f ms, %u journaled changes, applied in %.2f ms",
+            config->parse_us / 1000.0, config->journal->len,
+            (g_get_monotonic_time() - start) / 1000.0);
+    parsed_config_free(config);
+}
+
+/* Only reads the paths, which stay as they are for the launcher's lifetime */
+static gpointer parse_thread(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+
+    return parse_configuration(launcher->config_path, launcher->journal_path);
+}
+
+/* Start parsing the configuration on a thread, see load_configuration_finish() */
+GThread* load_configuration_begin(LauncherPlugin *launcher) {
+    return g_thread_new("launcher-config", parse_thread, launcher);
+}
+
+void load_configuration_finish(LauncherPlugin *launcher, GThread *parser) {
+    apply_configuration(launcher, g_thread_join(parser));
+}
+
+void load_configuration(LauncherPlugin *launcher) {
+    apply_configuration(launcher, parse_configuration(launcher->config_path, launcher->journal_path));
 }
@@ -10,34 +10,37 @@
 #include <string.h>
 #include <math.h>
 
+/* Keys that edit the search text while the entry has focus and holds some */
+static gboolean is_entry_editing_key(LauncherPlugin *launcher, guint keyval) {
+    if (!gtk_widget_has_focus(launcher->search_entry) ||
+        gtk_entry_get_text_length(GTK_ENTRY(launcher->search_entry)) == 0)
+        return FALSE;
+
+    return keyval == GDK_KEY_Left || keyval == GDK_KEY_Right ||
+           keyval == GDK_KEY_Home || keyval == GDK_KEY_End;
+}
+
 gboolean on_key_press(GtkWidget *widget, GdkEventKey *event, LauncherPlugin *launcher) {
-    switch (event->keyval) {
-        case GDK_KEY_Escape:
-            hide_overlay(launcher);
-            return TRUE;
-        case GDK_KEY_Right:
-            if (launcher->current_page < launcher->total_pages - 1) {
-                launcher->current_page++;
-                populate_current_page(launcher);
-                update_page_dots(launcher);
-                return TRUE;
-            }
-            break;
-        case GDK_KEY_Left:
-            if (launcher->current_page > 0) {
-                launcher->current_page--;
-                populate_current_page(launcher);
-                update_page_dots(launcher);
-                return TRUE;
-            }
-            break;
+    if (event->keyval == GDK_KEY_Escape) {
+        hide_overlay(launcher);
+        return TRUE;
+    }
+
+    if (!is_entry_editing_key(launcher, event->keyval) && navigation_handle_key(launcher, event))
+        return TRUE;
+
+    /* Type-to-search from anywhere, the search entry takes the key and the focus */
+    if (!gtk_widget_has_focus(launcher->search_entry) &&
+        gtk_search_entry_handle_event(GTK_SEARCH_ENTRY(launcher->search_entry), (GdkEvent *)event)) {
+        gtk_entry_grab_focus_without_selecting(GTK_ENTRY(launcher->search_entry));
+        return TRUE;
     }
+
     return FALSE;
 }
 
 void on_search_changed(GtkSearchEntry *entry, LauncherPlugin *launcher) {
     const gchar *search_text = gtk_entry_get_text(GTK_ENTRY(entry));
-    GList *iter;
     
     if (launcher->filtered_list) {
         g_list_free(launcher->filtered_list);
@@ -48,25 +51,18 @@ void on_search_changed(GtkSearchEntry *entry, LauncherPlugin *launcher) {
     if (strlen(search_text) == 0) {
         launcher->filtered_list = g_list_copy(launcher->app_list);
     } else {
-        gchar *search_lower = g_utf8_strdown(search_text, -1);
-        
-        for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
-            AppInfo *app_info = (AppInfo *)iter->data;
-            if (app_info && app_info->name && !app_info->is_hidden) {
-                gchar *name_lower = g_utf8_strdown(app_info->name, -1);
-                if (strstr(name_lower, search_lower) != NULL) {
-                    launcher->filtered_list = g_list_append(launcher->filtered_list, app_info);
-                }
-                g_free(name_lower);
-            }
-        }
-        
-        g_free(search_lower);
+        /* Matches the user starts often come first, see search.c */
+        launcher->filtered_list = search_applications(launcher, search_text);
     }
     
+    invalidate_page_index(launcher);
     launcher->current_page = 0;
     populate_current_page(launcher);
     update_page_dots(launcher);
+
+    /* Enter launches the top result, show which one */
+    if (strlen(search_text) > 0)
+        selection_set(launcher, 0);
 }
 
 void on_dot_clicked(GtkWidget *dot, gpointer data) {
@@ -74,86 +70,114 @@ void on_dot_clicked(GtkWidget *dot, gpointer data) {
     LauncherPlugin *launcher = g_object_get_data(G_OBJECT(dot), "launcher");
     
     if (launcher && page_index != launcher->current_page) {
-        launcher->current_page = page_index;
-        populate_current_page(launcher);
-        update_page_dots(launcher);
+        show_page(launcher, page_index);
     }
 }
 
 gboolean on_scroll_event(GtkWidget *widget, GdkEventScroll *event, LauncherPlugin *launcher) {
-    gboolean changed = FALSE;
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(widget);
+    gint step = 0, page;
     
     switch (event->direction) {
         case GDK_SCROLL_LEFT:
         case GDK_SCROLL_UP:
-            if (launcher->current_page > 0) {
-                launcher->current_page--;
-                changed = TRUE;
-            }
+            step = -1;
             break;
             
         case GDK_SCROLL_RIGHT:
         case GDK_SCROLL_DOWN:
-            if (launcher->current_page < launcher->total_pages - 1) {
-                launcher->current_page++;
-                changed = TRUE;
-            }
+            step = 1;
             break;
             
         case GDK_SCROLL_SMOOTH:
-            if (fabs(event->delta_x) > fabs(event->delta_y)) {
-                if (event->delta_x < -0.3) {
-                    if (launcher->current_page > 0) {
-                        launcher->current_page--;
-                        changed = TRUE;
-                    }
-                } else if (event->delta_x > 0.3) {
-                    if (launcher->current_page < launcher->total_pages - 1) {
-                        launcher->current_page++;
-                        changed = TRUE;
-                    }
-                }
-            } else {
-                if (event->delta_y < -0.3) {
-                    if (launcher->current_page > 0) {
-                        launcher->current_page--;
-                        changed = TRUE;
-                    }
-                } else if (event->delta_y > 0.3) {
-                    if (launcher->current_page < launcher->total_pages - 1) {
-                        launcher->current_page++;
-                        changed = TRUE;
-                    }
-                }
-            }
+            /* A flick sends dozens of events, they are integrated into one page change */
+            step = scroll_accumulator_feed(&launcher->scroll, event->delta_x, event->delta_y,
+                                           (gint64)event->time * 1000,
+                                           gdk_event_is_scroll_stop_event((GdkEvent *)event));
             break;
             
         default:
             break;
     }
     
-    if (changed) {
-        populate_current_page(launcher);
-        update_page_dots(launcher);
-    }
+    /* Scrolling past the first or last page changes nothing, so it does not use up the frame */
+    page = launcher->current_page + step;
+    if (step == 0 || page < 0 || page >= launcher->total_pages)
+        return TRUE;
+    
+    if (clock && !scroll_accumulator_claim_frame(&launcher->scroll, gdk_frame_clock_get_frame_counter(clock)))
+        return TRUE;
+    
+    show_page(launcher, page);
     
     return TRUE;
 }
 
+/* Only touch and touchpad swipes move the pages with the fingers */
+static gboolean is_touch_swipe(GtkGesture *gesture, GdkEventSequence *sequence) {
+    const GdkEvent *event = gtk_gesture_get_last_event(gesture, sequence);
+
+    if (!event)
+        return FALSE;
+
+    switch (gdk_event_get_event_type(event)) {
+        case GDK_TOUCHPAD_SWIPE:
+        case GDK_TOUCH_BEGIN:
+        case GDK_TOUCH_UPDATE:
+        case GDK_TOUCH_END:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+void on_swipe_begin(GtkGesture *gesture, GdkEventSequence *sequence, LauncherPlugin *launcher) {
+    gdouble y;
+
+    launcher->swipe_tracking = FALSE;
+    gtk_gesture_get_bounding_box_center(gesture, &launcher->swipe_start_x, &y);
+}
+
+void on_swipe_update(GtkGesture *gesture, GdkEventSequence *sequence, LauncherPlugin *launcher) {
+    gdouble x, y;
+
+    if (!launcher->drawn_grid || launcher->page_transition == PAGE_TRANSITION_NONE ||
+        !is_touch_swipe(gesture, sequence) ||
+        !gtk_gesture_get_bounding_box_center(gesture, &x, &y))
+        return;
+
+    launcher->swipe_tracking = TRUE;
+    tile_grid_swipe_update(launcher->app_grid, x - launcher->swipe_start_x);
+}
+
+/* Another gesture claimed the touch sequence, nothing changes page */
+void on_swipe_cancel(GtkGesture *gesture, GdkEventSequence *sequence, LauncherPlugin *launcher) {
+    if (!launcher->swipe_tracking)
+        return;
+
+    launcher->swipe_tracking = FALSE;
+    tile_grid_swipe_cancel(launcher->app_grid);
+}
+
 void on_swipe_gesture(GtkGestureSwipe *gesture, gdouble velocity_x, gdouble velocity_y, LauncherPlugin *launcher) {
-    gboolean changed = FALSE;
+    gint step;
     
-    if (velocity_x > 0 && launcher->current_page > 0) {
-        launcher->current_page--;
-        changed = TRUE;
-    } else if (velocity_x < 0 && launcher->current_page < launcher->total_pages - 1) {
-        launcher->current_page++;
-        changed = TRUE;
+    /* A tracked swipe settles by itself, only the page change is left to do */
+    if (launcher->swipe_tracking) {
+        launcher->swipe_tracking = FALSE;
+        step = tile_grid_swipe_end(launcher->app_grid, velocity_x);
+        if (step != 0) {
+            launcher->current_page += step;
+            populate_current_page(launcher);
+            update_page_dots(launcher);
+        }
+        return;
     }
     
-    if (changed) {
-        populate_current_page(launcher);
-        update_page_dots(launcher);
+    if (velocity_x > 0) {
+        show_page(launcher, launcher->current_page - 1);
+    } else if (velocity_x < 0) {
+        show_page(launcher, launcher->current_page + 1);
     }
 }
 
@@ -171,6 +195,7 @@ void on_folder_clicked(GtkWidget *button, FolderInfo *folder_info) {
         launcher->open_folder = folder_info;
         g_list_free(launcher->filtered_list);
         launcher->filtered_list = g_list_copy(folder_info->apps);
+        invalidate_page_index(launcher);
         launcher->current_page = 0;
         populate_current_page(launcher);
         update_page_dots(launcher);
@@ -182,6 +207,7 @@ void on_back_button_clicked(GtkWidget *button, LauncherPlugin *launcher) {
     launcher->open_folder = NULL;
     g_list_free(launcher->filtered_list);
     launcher->filtered_list = g_list_copy(launcher->app_list);
+    invalidate_page_index(launcher);
     launcher->current_page = 0;
     populate_current_page(launcher);
     update_page_dots(launcher);
@@ -214,6 +240,74 @@ gboolean on_button_press_event(GtkWidget *widget, GdkEventButton *event, AppInfo
     return FALSE;
 }
 
+static void on_rename_folder_activate(GtkMenuItem *menuitem, LauncherPlugin *launcher) {
+    FolderInfo *folder_info = g_object_get_data(G_OBJECT(menuitem), "folder-info");
+    GtkWidget *dialog, *entry;
+    const gchar *name;
+
+    dialog = gtk_dialog_new_with_buttons("Rename Folder", GTK_WINDOW(launcher->overlay_window),
+                                        GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+                                        "_Cancel", GTK_RESPONSE_CANCEL,
+                                        "_Rename", GTK_RESPONSE_OK,
+                                        NULL);
+    gtk_dialog_set_default_response(GTK_DIALOG(dialog), GTK_RESPONSE_OK);
+
+    entry = gtk_entry_new();
+    gtk_entry_set_text(GTK_ENTRY(entry), folder_info->name);
+    gtk_entry_set_activates_default(GTK_ENTRY(entry), TRUE);
+    gtk_container_set_border_width(GTK_CONTAINER(dialog), 6);
+    gtk_box_pack_start(GTK_BOX(gtk_dialog_get_content_area(GTK_DIALOG(dialog))), entry, FALSE, FALSE, 6);
+    gtk_widget_show_all(dialog);
+
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_OK) {
+        name = gtk_entry_get_text(GTK_ENTRY(entry));
+        if (*name && g_strcmp0(name, folder_info->name) != 0) {
+            rename_folder(launcher, folder_info, name);
+            populate_current_page(launcher);
+        }
+    }
+    gtk_widget_destroy(dialog);
+}
+
+static void on_delete_folder_activate(GtkMenuItem *menuitem, LauncherPlugin *launcher) {
+    FolderInfo *folder_info = g_object_get_data(G_OBJECT(menuitem), "folder-info");
+
+    delete_folder(launcher, folder_info);
+    populate_current_page(launcher);
+    update_page_dots(launcher);
+}
+
+/* Right click on a folder tile, the folder is left as data on the items */
+gboolean on_folder_button_press_event(GtkWidget *widget, GdkEventButton *event, FolderInfo *folder_info) {
+    if (event->type == GDK_BUTTON_PRESS && event->button == 3) {
+        LauncherPlugin *launcher = g_object_get_data(G_OBJECT(widget), "launcher");
+        GtkWidget *menu, *rename_item, *delete_item;
+
+        if (!launcher) {
+            g_warning("Launcher reference not found in button data");
+            return FALSE;
+        }
+
+        menu = gtk_menu_new();
+        rename_item = gtk_menu_item_new_with_label("Rename...");
+        delete_item = gtk_menu_item_new_with_label("Delete");
+        g_object_set_data(G_OBJECT(rename_item), "folder-info", folder_info);
+        g_object_set_data(G_OBJECT(delete_item), "folder-info", folder_info);
+
+        g_signal_connect(rename_item, "activate",
+                         G_CALLBACK(on_rename_folder_activate), launcher);
+        g_signal_connect(delete_item, "activate",
+                         G_CALLBACK(on_delete_folder_activate), launcher);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), rename_item);
+        gtk_menu_shell_append(GTK_MENU_SHELL(menu), delete_item);
+        gtk_widget_show_all(menu);
+        gtk_menu_popup_at_pointer(GTK_MENU(menu), (GdkEvent *)event);
+
+        return TRUE;
+    }
+    return FALSE;
+}
+
 /* Drag and drop handlers */
 void on_drag_begin(GtkWidget *widget, GdkDragContext *context, gpointer user_data) {
     LauncherPlugin *launcher = g_object_get_data(G_OBJECT(widget), "launcher");
@@ -242,15 +336,52 @@ void on_drag_data_get(GtkWidget *widget, GdkDragContext *context, GtkSelectionDa
     }
 }
 
+/*
+ * Move the dragged app to the tile at index, or after the last tile. The
+ * app takes the place of the app shown there, so hidden apps and apps in
+ * folders keep their places around it; only the tiles in between change.
+ */
+static void reorder_to_tile(LauncherPlugin *launcher, gint index) {
+    gint from = page_index_find_item(launcher, launcher->drag_source);
+    gint count = page_index_get_item_count(launcher);
+    GridItem *target;
+
+    if (from < 0)
+        return;
+
+    /* Folders come before the apps, a drop among them moves the app to the front */
+    index = CLAMP(index, launcher->frequent_count, count - 1);
+    while ((target = page_index_get_item(launcher, index)) && target->folder_info)
+        index++;
+    if (!target || index == from)
+        return;
+
+    move_application(launcher, launcher->drag_source, target->app_info, from < index);
+    page_index_move_item(launcher, from, index);
+    refresh_page_tiles(launcher, MIN(from, index), MAX(from, index));
+}
+
 gboolean on_drag_drop(GtkWidget *widget, GdkDragContext *context, gint x, gint y, guint time, LauncherPlugin *launcher) {
     if (!launcher->drag_source) {
         gtk_drag_finish(context, FALSE, FALSE, time);
         return FALSE;
     }
 
-    GtkWidget *target_widget = gtk_grid_get_child_at(GTK_GRID(launcher->app_grid), x / BUTTON_SIZE, y / BUTTON_SIZE);
-    AppInfo *target_app = target_widget ? g_object_get_data(G_OBJECT(target_widget), "app-info") : NULL;
-    FolderInfo *target_folder = target_widget ? g_object_get_data(G_OBJECT(target_widget), "folder-info") : NULL;
+    AppInfo *target_app = NULL;
+    FolderInfo *target_folder = NULL;
+
+    if (launcher->drawn_grid) {
+        GridItem item;
+        if (tile_grid_hit_test(launcher->app_grid, x, y, &item)) {
+            target_app = item.app_info;
+            target_folder = item.folder_info;
+        }
+    } else {
+        GtkWidget *target_widget = gtk_grid_get_child_at(GTK_GRID(launcher->app_grid),
+                                                         x / launcher->layout.pitch, y / launcher->layout.pitch);
+        target_app = target_widget ? g_object_get_data(G_OBJECT(target_widget), "app-info") : NULL;
+        target_folder = target_widget ? g_object_get_data(G_OBJECT(target_widget), "folder-info") : NULL;
+    }
 
     gboolean success = FALSE;
 
@@ -258,6 +389,7 @@ gboolean on_drag_drop(GtkWidget *widget, GdkDragContext *context, gint x, gint y
         /* Dropped on another app -> create a folder */
         FolderInfo *folder = create_folder("New Folder");
         launcher->folder_list = g_list_append(launcher->folder_list, folder);
+        journal_record_folder_add(launcher, folder);
 
         add_app_to_folder(launcher, launcher->drag_source, folder->id);
         add_app_to_folder(launcher, target_app, folder->id);
@@ -267,27 +399,29 @@ gboolean on_drag_drop(GtkWidget *widget, GdkDragContext *context, gint x, gint y
         /* Dropped on a folder -> add to folder */
         add_app_to_folder(launcher, launcher->drag_source, target_folder->id);
         success = TRUE;
-    } else {
-        /* Dropped on empty space -> reorder */
-        gint page_offset = launcher->current_page * APPS_PER_PAGE;
-        gint new_index = (y / BUTTON_SIZE) * GRID_COLUMNS + (x / BUTTON_SIZE) + page_offset;
-
-        launcher->app_list = g_list_remove(launcher->app_list, launcher->drag_source);
-        launcher->app_list = g_list_insert(launcher->app_list, launcher->drag_source, new_index);
+    } else if (launcher->frequent_count == 0 || launcher->current_page > 0) {
+        /* Dropped on empty space -> reorder, the "Frequent" page has no order of its own */
+        gint column = MIN(x / launcher->layout.pitch, launcher->layout.columns - 1);
+        gint row = y / launcher->layout.pitch;
 
-        recalculate_positions(launcher);
-        success = TRUE;
+        reorder_to_tile(launcher, page_index_get_page_start(launcher, launcher->current_page) +
+                                  row * launcher->layout.columns + column);
+        launcher->drag_source = NULL;
+        gtk_drag_finish(context, TRUE, FALSE, time);
+        return TRUE;
     }
 
+    /* The drag is over either way, a later drop must not move this app */
+    launcher->drag_source = NULL;
+
     if (success) {
+        invalidate_page_index(launcher);
         populate_current_page(launcher);
         update_page_dots(launcher);
-        save_configuration(launcher);
         gtk_drag_finish(context, TRUE, FALSE, time);
         return TRUE;
     }
 
-    launcher->drag_source = NULL;
     gtk_drag_finish(context, FALSE, FALSE, time);
     return FALSE;
 }
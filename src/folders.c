@@ -58,6 +58,54 @@ void add_app_to_folder(LauncherPlugin *launcher, AppInfo *app, const gchar *fold
         /* Add to new folder */
         app->folder_id = g_strdup(folder_id);
         folder->apps = g_list_append(folder->apps, app);
+        journal_record_folder_app(launcher, app);
+        invalidate_page_index(launcher);
+    }
+}
+
+void rename_folder(LauncherPlugin *launcher, FolderInfo *folder, const gchar *name) {
+    g_free(folder->name);
+    folder->name = g_strdup(name);
+    journal_record_folder_rename(launcher, folder);
+    invalidate_page_index(launcher);
+}
+
+/* Remove a folder, its apps go back to the grid */
+void delete_folder(LauncherPlugin *launcher, FolderInfo *folder) {
+    GList *iter;
+
+    for (iter = folder->apps; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        g_free(app->folder_id);
+        app->folder_id = NULL;
+    }
+
+    journal_record_folder_remove(launcher, folder);
+    launcher->folder_list = g_list_remove(launcher->folder_list, folder);
+    if (launcher->open_folder == folder)
+        launcher->open_folder = NULL;
+    free_folder_info(folder);
+    invalidate_page_index(launcher);
+}
+
+/* Fill the folders with their apps, apps of folders that are gone are let go */
+void folders_join_apps(LauncherPlugin *launcher) {
+    GList *iter;
+
+    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app = (AppInfo *)iter->data;
+        FolderInfo *folder;
+
+        if (!app->folder_id)
+            continue;
+
+        folder = find_folder_by_id(launcher, app->folder_id);
+        if (folder) {
+            folder->apps = g_list_append(folder->apps, app);
+        } else {
+            g_free(app->folder_id);
+            app->folder_id = NULL;
+        }
     }
 }
 
@@ -69,5 +117,7 @@ void remove_app_from_folder(LauncherPlugin *launcher, AppInfo *app) {
         }
         g_free(app->folder_id);
         app->folder_id = NULL;
+        journal_record_folder_app(launcher, app);
+        invalidate_page_index(launcher);
     }
 }
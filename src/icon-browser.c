@@ -0,0 +1,514 @@
+/*
+ * Icon theme browser for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <string.h>
+
+/*
+ * A drawn grid of every icon in the current theme. Only the rows in view
+ * are drawn, and only their icons are decoded, in the background and
+ * into the catalog's icon tier for the browser's size, shared with the
+ * overlays. A scrollbar drives the grid instead of a viewport, so the
+ * widget stays one screen tall whatever the size of the theme.
+ */
+
+#define BROWSER_ICON_SIZE 48
+#define CELL_WIDTH 112
+#define CELL_HEIGHT 88
+#define CELL_PADDING 6
+/* Decodes in flight, icons scrolled past are never started */
+#define MAX_DECODES 8
+
+typedef struct {
+    GtkWidget       *area;
+    GtkAdjustment   *adjustment;
+    GPtrArray       *names;
+    GPtrArray       *shown;
+    gchar           *filter;
+    gchar           *pending_selection;
+    gint            selected;
+    gint            columns;
+    gint            scale;
+    gpointer        tier_key;
+    GHashTable      *icons;
+    GHashTable      *failed;
+    GHashTable      *decoding;
+    GQueue          *wanted;
+    GCancellable    *cancellable;
+    guint           list_source;
+    IconBrowserFunc func;
+    gpointer        data;
+} IconBrowser;
+
+typedef struct {
+    IconBrowser *browser;
+    gchar       *name;
+    gint        scale;
+} DecodeJob;
+
+static void start_decodes(IconBrowser *browser);
+
+static IconBrowser* get_icon_browser(GtkWidget *widget) {
+    return g_object_get_data(G_OBJECT(widget), "icon-browser");
+}
+
+static void release_tier(IconBrowser *browser) {
+    if (browser->icons) {
+        catalog_release_icon_tier(browser->tier_key);
+        browser->icons = NULL;
+    }
+}
+
+static void icon_browser_free(IconBrowser *browser) {
+    /* Decodes still running finish into the void */
+    g_cancellable_cancel(browser->cancellable);
+    g_object_unref(browser->cancellable);
+    if (browser->list_source)
+        g_source_remove(browser->list_source);
+    release_tier(browser);
+    g_ptr_array_unref(browser->shown);
+    if (browser->names)
+        g_ptr_array_unref(browser->names);
+    g_hash_table_destroy(browser->failed);
+    g_hash_table_destroy(browser->decoding);
+    g_queue_free_full(browser->wanted, g_free);
+    g_free(browser->filter);
+    g_free(browser->pending_selection);
+    g_free(browser);
+}
+
+static gint get_row_count(IconBrowser *browser) {
+    return (browser->shown->len + browser->columns - 1) / browser->columns;
+}
+
+static void update_adjustment(IconBrowser *browser) {
+    gint width = gtk_widget_get_allocated_width(browser->area);
+    gint height = gtk_widget_get_allocated_height(browser->area);
+    gdouble upper;
+
+    browser->columns = MAX(1, width / CELL_WIDTH);
+    upper = (gdouble)get_row_count(browser) * CELL_HEIGHT;
+    gtk_adjustment_configure(browser->adjustment,
+                             CLAMP(gtk_adjustment_get_value(browser->adjustment), 0, MAX(0, upper - height)),
+                             0, MAX(upper, height), CELL_HEIGHT, height * 0.9, height);
+}
+
+static void get_cell_rect(IconBrowser *browser, gint index, GdkRectangle *rect) {
+    gint width = gtk_widget_get_allocated_width(browser->area);
+    gint margin = (width - browser->columns * CELL_WIDTH) / 2;
+
+    rect->x = margin + (index % browser->columns) * CELL_WIDTH;
+    rect->y = (index / browser->columns) * CELL_HEIGHT - (gint)gtk_adjustment_get_value(browser->adjustment);
+    rect->width = CELL_WIDTH;
+    rect->height = CELL_HEIGHT;
+}
+
+static gint get_cell_at(IconBrowser *browser, gdouble x, gdouble y) {
+    gint width = gtk_widget_get_allocated_width(browser->area);
+    gint margin = (width - browser->columns * CELL_WIDTH) / 2;
+    gint col, row, index;
+
+    x -= margin;
+    y += gtk_adjustment_get_value(browser->adjustment);
+    if (x < 0 || y < 0)
+        return -1;
+
+    col = (gint)x / CELL_WIDTH;
+    row = (gint)y / CELL_HEIGHT;
+    if (col >= browser->columns)
+        return -1;
+
+    index = row * browser->columns + col;
+    return index < (gint)browser->shown->len ? index : -1;
+}
+
+/* The shared tier for the browser's icon size at the widget's scale */
+static GHashTable* get_icons(IconBrowser *browser) {
+    gint scale = gtk_widget_get_scale_factor(browser->area);
+
+    if (!browser->icons || browser->scale != scale) {
+        release_tier(browser);
+        browser->scale = scale;
+        browser->tier_key = GINT_TO_POINTER(scale << 16 | BROWSER_ICON_SIZE);
+        browser->icons = catalog_acquire_icon_tier(browser->tier_key);
+    }
+
+    return browser->icons;
+}
+
+static void on_icon_decoded(GObject *source, GAsyncResult *result, gpointer data) {
+    DecodeJob *job = (DecodeJob *)data;
+    IconBrowser *browser = job->browser;
+    GError *error = NULL;
+    GdkPixbuf *pixbuf = gtk_icon_info_load_icon_finish(GTK_ICON_INFO(source), result, &error);
+
+    if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_error_free(error);
+        g_free(job->name);
+        g_free(job);
+        return;
+    }
+
+    g_hash_table_remove(browser->decoding, job->name);
+    if (pixbuf && job->scale == browser->scale) {
+        cairo_surface_t *surface = gdk_cairo_surface_create_from_pixbuf(pixbuf, job->scale,
+                                                                        gtk_widget_get_window(browser->area));
+        catalog_insert_icon(browser->tier_key, job->name, surface);
+    } else if (!pixbuf) {
+        g_hash_table_add(browser->failed, g_strdup(job->name));
+    }
+
+    g_clear_error(&error);
+    if (pixbuf)
+        g_object_unref(pixbuf);
+    g_free(job->name);
+    g_free(job);
+
+    gtk_widget_queue_draw(browser->area);
+    start_decodes(browser);
+}
+
+/* Start decoding the icons drawn last, the theme lookup is cheap, the decode is not */
+static void start_decodes(IconBrowser *browser) {
+    GtkIconTheme *icon_theme = gtk_icon_theme_get_for_screen(gtk_widget_get_screen(browser->area));
+    gchar *name;
+
+    while (g_hash_table_size(browser->decoding) < MAX_DECODES &&
+           (name = g_queue_pop_head(browser->wanted)) != NULL) {
+        GtkIconInfo *info;
+        DecodeJob *job;
+
+        if (g_hash_table_contains(browser->decoding, name)) {
+            g_free(name);
+            continue;
+        }
+
+        info = gtk_icon_theme_lookup_icon_for_scale(icon_theme, name, BROWSER_ICON_SIZE, browser->scale,
+                                                    GTK_ICON_LOOKUP_FORCE_SIZE);
+        if (!info) {
+            g_hash_table_add(browser->failed, name);
+            continue;
+        }
+
+        job = g_new0(DecodeJob, 1);
+        job->browser = browser;
+        job->name = name;
+        job->scale = browser->scale;
+        g_hash_table_add(browser->decoding, g_strdup(name));
+        gtk_icon_info_load_icon_async(info, browser->cancellable, on_icon_decoded, job);
+        g_object_unref(info);
+    }
+}
+
+static void draw_cell(IconBrowser *browser, GtkStyleContext *context, cairo_t *cr, gint index,
+                      GHashTable *icons) {
+    const gchar *name = g_ptr_array_index(browser->shown, index);
+    cairo_surface_t *surface = g_hash_table_lookup(icons, name);
+    GdkRectangle rect;
+    PangoLayout *layout;
+    gint text_height;
+
+    get_cell_rect(browser, index, &rect);
+
+    gtk_style_context_save(context);
+    if (index == browser->selected) {
+        gtk_style_context_set_state(context, GTK_STATE_FLAG_SELECTED);
+        gtk_render_background(context, cr, rect.x + 2, rect.y + 2, rect.width - 4, rect.height - 4);
+    }
+
+    if (surface) {
+        gtk_render_icon_surface(context, cr, surface,
+                                rect.x + (rect.width - BROWSER_ICON_SIZE) / 2, rect.y + CELL_PADDING);
+    } else if (!g_hash_table_contains(browser->failed, name) &&
+               !g_hash_table_contains(browser->decoding, name)) {
+        g_queue_push_tail(browser->wanted, g_strdup(name));
+    }
+
+    layout = gtk_widget_create_pango_layout(browser->area, name);
+    pango_layout_set_width(layout, (rect.width - 2 * CELL_PADDING) * PANGO_SCALE);
+    pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_MIDDLE);
+    pango_layout_set_alignment(layout, PANGO_ALIGN_CENTER);
+    pango_layout_get_pixel_size(layout, NULL, &text_height);
+    gtk_render_layout(context, cr, rect.x + CELL_PADDING,
+                      rect.y + rect.height - CELL_PADDING - text_height, layout);
+    g_object_unref(layout);
+
+    gtk_style_context_restore(context);
+}
+
+/* Draw the rows in view, whatever the number of icons */
+static gboolean on_icon_browser_draw(GtkWidget *widget, cairo_t *cr, IconBrowser *browser) {
+    GtkStyleContext *context = gtk_widget_get_style_context(widget);
+    gint height = gtk_widget_get_allocated_height(widget);
+    gint value = (gint)gtk_adjustment_get_value(browser->adjustment);
+    GHashTable *icons = get_icons(browser);
+    gint first, last, i;
+
+    gtk_render_background(context, cr, 0, 0, gtk_widget_get_allocated_width(widget), height);
+
+    /* Only what is on screen now is worth decoding */
+    g_queue_free_full(browser->wanted, g_free);
+    browser->wanted = g_queue_new();
+
+    first = (value / CELL_HEIGHT) * browser->columns;
+    last = MIN((gint)browser->shown->len, ((value + height) / CELL_HEIGHT + 1) * browser->columns);
+    for (i = first; i < last; i++)
+        draw_cell(browser, context, cr, i, icons);
+
+    start_decodes(browser);
+
+    return FALSE;
+}
+
+static void scroll_to_cell(IconBrowser *browser, gint index) {
+    gdouble value = gtk_adjustment_get_value(browser->adjustment);
+    gdouble page = gtk_adjustment_get_page_size(browser->adjustment);
+    gdouble top = (index / browser->columns) * CELL_HEIGHT;
+
+    if (top < value)
+        gtk_adjustment_set_value(browser->adjustment, top);
+    else if (top + CELL_HEIGHT > value + page)
+        gtk_adjustment_set_value(browser->adjustment, top + CELL_HEIGHT - page);
+}
+
+static void set_selected(IconBrowser *browser, gint index, gboolean activated) {
+    if (index < 0 || index >= (gint)browser->shown->len)
+        return;
+
+    browser->selected = index;
+    scroll_to_cell(browser, index);
+    gtk_widget_queue_draw(browser->area);
+
+    if (browser->func)
+        browser->func(g_ptr_array_index(browser->shown, index), activated, browser->data);
+}
+
+/* The names matching the search, in theme order */
+static void apply_filter(IconBrowser *browser) {
+    const gchar *selected_name = browser->selected >= 0 ?
+                                 g_ptr_array_index(browser->shown, browser->selected) : NULL;
+    gint selected = -1;
+    guint i;
+
+    g_ptr_array_set_size(browser->shown, 0);
+    for (i = 0; browser->names && i < browser->names->len; i++) {
+        const gchar *name = g_ptr_array_index(browser->names, i);
+
+        if (!browser->filter || strstr(name, browser->filter))
+            g_ptr_array_add(browser->shown, (gpointer)name);
+        if (name == selected_name && (!browser->filter || strstr(name, browser->filter)))
+            selected = browser->shown->len - 1;
+    }
+
+    browser->selected = selected;
+    gtk_adjustment_set_value(browser->adjustment, 0);
+    update_adjustment(browser);
+    if (selected >= 0)
+        scroll_to_cell(browser, selected);
+    gtk_widget_queue_draw(browser->area);
+}
+
+static void apply_pending_selection(IconBrowser *browser) {
+    guint i;
+
+    for (i = 0; i < browser->shown->len; i++) {
+        if (g_strcmp0(g_ptr_array_index(browser->shown, i), browser->pending_selection) == 0) {
+            browser->selected = i;
+            scroll_to_cell(browser, i);
+            gtk_widget_queue_draw(browser->area);
+            break;
+        }
+    }
+    g_clear_pointer(&browser->pending_selection, g_free);
+}
+
+static gint compare_names(gconstpointer a, gconstpointer b) {
+    return g_strcmp0(*(const gchar **)a, *(const gchar **)b);
+}
+
+/* Listing a large theme takes a while, the dialog is already on screen by then */
+static gboolean list_icons(gpointer data) {
+    IconBrowser *browser = (IconBrowser *)data;
+    GtkIconTheme *icon_theme = gtk_icon_theme_get_for_screen(gtk_widget_get_screen(browser->area));
+    gint64 start = g_get_monotonic_time();
+    GList *names, *iter;
+
+    browser->list_source = 0;
+    if (browser->names)
+        g_ptr_array_unref(browser->names);
+    browser->names = g_ptr_array_new_with_free_func(g_free);
+    browser->selected = -1;
+
+    names = gtk_icon_theme_list_icons(icon_theme, NULL);
+    for (iter = names; iter != NULL; iter = g_list_next(iter))
+        g_ptr_array_add(browser->names, iter->data);
+    g_list_free(names);
+    g_ptr_array_sort(browser->names, compare_names);
+
+    apply_filter(browser);
+    g_debug("Icon browser: %u icons listed in %.2f ms", browser->names->len,
+            (g_get_monotonic_time() - start) / 1000.0);
+
+    if (browser->pending_selection)
+        apply_pending_selection(browser);
+
+    return G_SOURCE_REMOVE;
+}
+
+static void schedule_list(IconBrowser *browser) {
+    if (!browser->list_source)
+        browser->list_source = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, list_icons, browser, NULL);
+}
+
+static void on_icon_browser_map(GtkWidget *widget, IconBrowser *browser) {
+    if (!browser->names)
+        schedule_list(browser);
+}
+
+static void on_icon_browser_size_allocate(GtkWidget *widget, GdkRectangle *allocation,
+                                          IconBrowser *browser) {
+    update_adjustment(browser);
+}
+
+static void on_adjustment_value_changed(GtkAdjustment *adjustment, IconBrowser *browser) {
+    gtk_widget_queue_draw(browser->area);
+}
+
+static gboolean on_icon_browser_button_press(GtkWidget *widget, GdkEventButton *event,
+                                             IconBrowser *browser) {
+    gint index = get_cell_at(browser, event->x, event->y);
+
+    gtk_widget_grab_focus(widget);
+    if (event->button != 1 || index < 0)
+        return FALSE;
+
+    set_selected(browser, index, event->type == GDK_2BUTTON_PRESS);
+    return TRUE;
+}
+
+static gboolean on_icon_browser_scroll(GtkWidget *widget, GdkEventScroll *event, IconBrowser *browser) {
+    gdouble value = gtk_adjustment_get_value(browser->adjustment);
+    gdouble dx, dy;
+
+    if (gdk_event_get_scroll_deltas((GdkEvent *)event, &dx, &dy))
+        value += dy * CELL_HEIGHT;
+    else if (event->direction == GDK_SCROLL_UP)
+        value -= CELL_HEIGHT;
+    else if (event->direction == GDK_SCROLL_DOWN)
+        value += CELL_HEIGHT;
+
+    gtk_adjustment_set_value(browser->adjustment, value);
+    return TRUE;
+}
+
+static gboolean on_icon_browser_key_press(GtkWidget *widget, GdkEventKey *event, IconBrowser *browser) {
+    gint index = MAX(browser->selected, 0);
+    gint rows = MAX(1, (gint)gtk_adjustment_get_page_size(browser->adjustment) / CELL_HEIGHT);
+
+    switch (event->keyval) {
+    case GDK_KEY_Left:
+        index--;
+        break;
+    case GDK_KEY_Right:
+        index++;
+        break;
+    case GDK_KEY_Up:
+        index -= browser->columns;
+        break;
+    case GDK_KEY_Down:
+        index += browser->columns;
+        break;
+    case GDK_KEY_Page_Up:
+        index -= rows * browser->columns;
+        break;
+    case GDK_KEY_Page_Down:
+        index += rows * browser->columns;
+        break;
+    case GDK_KEY_Return:
+    case GDK_KEY_KP_Enter:
+        set_selected(browser, browser->selected, TRUE);
+        return TRUE;
+    default:
+        return FALSE;
+    }
+
+    set_selected(browser, CLAMP(index, 0, (gint)browser->shown->len - 1), FALSE);
+    return TRUE;
+}
+
+/* A new theme has other icons, and other images for the same names */
+static void on_icon_theme_changed(GtkIconTheme *icon_theme, GtkWidget *widget) {
+    IconBrowser *browser = get_icon_browser(widget);
+
+    catalog_clear_icons();
+    g_hash_table_remove_all(browser->failed);
+    schedule_list(browser);
+}
+
+/* A scrollable grid of the theme's icons, func is called when one is picked */
+GtkWidget* icon_browser_new(IconBrowserFunc func, gpointer data) {
+    GtkWidget *box = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
+    GtkWidget *scrollbar;
+    IconBrowser *browser = g_new0(IconBrowser, 1);
+
+    browser->area = gtk_drawing_area_new();
+    browser->adjustment = gtk_adjustment_new(0, 0, 0, CELL_HEIGHT, 0, 0);
+    browser->shown = g_ptr_array_new();
+    browser->selected = -1;
+    browser->columns = 1;
+    browser->failed = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    browser->decoding = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+    browser->wanted = g_queue_new();
+    browser->cancellable = g_cancellable_new();
+    browser->func = func;
+    browser->data = data;
+
+    g_object_set_data_full(G_OBJECT(browser->area), "icon-browser", browser,
+                           (GDestroyNotify)icon_browser_free);
+    g_object_set_data(G_OBJECT(box), "icon-browser", browser);
+
+    gtk_style_context_add_class(gtk_widget_get_style_context(browser->area), GTK_STYLE_CLASS_VIEW);
+    gtk_widget_set_can_focus(browser->area, TRUE);
+    gtk_widget_add_events(browser->area, GDK_BUTTON_PRESS_MASK | GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK);
+    atk_object_set_role(gtk_widget_get_accessible(browser->area), ATK_ROLE_LIST);
+
+    g_signal_connect(browser->area, "draw", G_CALLBACK(on_icon_browser_draw), browser);
+    g_signal_connect(browser->area, "map", G_CALLBACK(on_icon_browser_map), browser);
+    g_signal_connect(browser->area, "size-allocate", G_CALLBACK(on_icon_browser_size_allocate), browser);
+    g_signal_connect(browser->area, "button-press-event", G_CALLBACK(on_icon_browser_button_press), browser);
+    g_signal_connect(browser->area, "scroll-event", G_CALLBACK(on_icon_browser_scroll), browser);
+    g_signal_connect(browser->area, "key-press-event", G_CALLBACK(on_icon_browser_key_press), browser);
+    g_signal_connect(browser->adjustment, "value-changed", G_CALLBACK(on_adjustment_value_changed), browser);
+    g_signal_connect_object(gtk_icon_theme_get_default(), "changed",
+                            G_CALLBACK(on_icon_theme_changed), browser->area, 0);
+
+    scrollbar = gtk_scrollbar_new(GTK_ORIENTATION_VERTICAL, browser->adjustment);
+    gtk_box_pack_start(GTK_BOX(box), browser->area, TRUE, TRUE, 0);
+    gtk_box_pack_start(GTK_BOX(box), scrollbar, FALSE, FALSE, 0);
+
+    return box;
+}
+
+/* Show only the icons whose name contains text, NULL or empty for all */
+void icon_browser_set_filter(GtkWidget *widget, const gchar *text) {
+    IconBrowser *browser = get_icon_browser(widget);
+
+    g_free(browser->filter);
+    browser->filter = text && *text ? g_ascii_strdown(text, -1) : NULL;
+    apply_filter(browser);
+}
+
+/* Select an icon by name, once the theme is listed if it is not yet */
+void icon_browser_select(GtkWidget *widget, const gchar *icon_name) {
+    IconBrowser *browser = get_icon_browser(widget);
+
+    g_free(browser->pending_selection);
+    browser->pending_selection = g_strdup(icon_name);
+    if (browser->names && !browser->list_source)
+        apply_pending_selection(browser);
+}
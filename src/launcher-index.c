@@ -0,0 +1,281 @@
+/*
+ * System catalog generator for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+/*
+ * xfce-launcher-index reads the .desktop files of the system application
+ * directories once and writes them to SYSTEM_CATALOG_PATH, see
+ * catalog-format.h. The packaging runs it from a trigger whenever
+ * packages install .desktop files, so logins map the result instead of
+ * every user scanning the same directories.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include "catalog-format.h"
+
+#define DESKTOP_GROUP "Desktop Entry"
+
+/* One application, strings already in the string table */
+typedef struct {
+    gchar        *id;
+    CatalogEntry entry;
+} IndexedApp;
+
+/* Append a string to the table, returns its offset */
+static guint32 add_string(GString *strings, const gchar *value) {
+    guint32 offset;
+
+    if (!value || !*value)
+        return 0;
+
+    offset = strings->len;
+    g_string_append_len(strings, value, strlen(value) + 1);
+    return offset;
+}
+
+/* Append the locale and name pairs as they are, each already terminated */
+static guint32 add_pairs(GString *strings, GString *pairs) {
+    guint32 offset;
+
+    if (pairs->len == 0)
+        return 0;
+
+    offset = strings->len;
+    g_string_append_len(strings, pairs->str, pairs->len);
+    g_string_append_c(strings, '\0');
+    return offset;
+}
+
+/* Icon names lose the image extension, absolute paths are not theme icons */
+static gchar* get_icon_name(GKeyFile *keyfile) {
+    gchar *icon = g_key_file_get_string(keyfile, DESKTOP_GROUP, "Icon", NULL);
+
+    if (!icon || g_path_is_absolute(icon)) {
+        g_free(icon);
+        return NULL;
+    }
+    if (g_str_has_suffix(icon, ".png") || g_str_has_suffix(icon, ".svg") ||
+        g_str_has_suffix(icon, ".xpm"))
+        icon[strlen(icon) - 4] = '\0';
+
+    return icon;
+}
+
+/* Every Name[locale] of the entry, for the plugin to pick from at runtime */
+static GString* get_localized_names(GKeyFile *keyfile) {
+    GString *names = g_string_new(NULL);
+    gchar **keys = g_key_file_get_keys(keyfile, DESKTOP_GROUP, NULL, NULL);
+    guint i;
+
+    for (i = 0; keys && keys[i]; i++) {
+        gchar *locale, *value;
+
+        if (!g_str_has_prefix(keys[i], "Name[") || !g_str_has_suffix(keys[i], "]"))
+            continue;
+
+        locale = g_strndup(keys[i] + 5, strlen(keys[i]) - 6);
+        value = g_key_file_get_string(keyfile, DESKTOP_GROUP, keys[i], NULL);
+        if (*locale && value && *value) {
+            g_string_append_len(names, locale, strlen(locale) + 1);
+            g_string_append_len(names, value, strlen(value) + 1);
+        }
+        g_free(value);
+        g_free(locale);
+    }
+    g_strfreev(keys);
+
+    return names;
+}
+
+static gchar* get_list(GKeyFile *keyfile, const gchar *key) {
+    gchar *value = g_key_file_get_string(keyfile, DESKTOP_GROUP, key, NULL);
+
+    if (value && !*value) {
+        g_free(value);
+        return NULL;
+    }
+    return value;
+}
+
+/*
+ * Read one .desktop file the way GDesktopAppInfo would: only applications
+ * with an Exec line unless D-Bus activatable. Hidden entries are kept to
+ * mask the same id further down the path. TryExec is left to the plugin,
+ * the program may come from a package without .desktop files.
+ */
+static gboolean index_file(GHashTable *apps, GString *strings, const gchar *path, const gchar *id) {
+    GKeyFile *keyfile = g_key_file_new();
+    IndexedApp *app;
+    gchar *type, *name, *exec, *try_exec, *icon, *only_show_in, *not_show_in;
+    GString *names;
+    gboolean hidden;
+
+    if (!g_key_file_load_from_file(keyfile, path, G_KEY_FILE_NONE, NULL)) {
+        g_key_file_free(keyfile);
+        return FALSE;
+    }
+
+    hidden = g_key_file_get_boolean(keyfile, DESKTOP_GROUP, "Hidden", NULL);
+    type = g_key_file_get_string(keyfile, DESKTOP_GROUP, "Type", NULL);
+    name = g_key_file_get_string(keyfile, DESKTOP_GROUP, "Name", NULL);
+    exec = g_key_file_get_string(keyfile, DESKTOP_GROUP, "Exec", NULL);
+    try_exec = g_key_file_get_string(keyfile, DESKTOP_GROUP, "TryExec", NULL);
+
+    app = g_new0(IndexedApp, 1);
+    app->id = g_strdup(id);
+    g_hash_table_insert(apps, app->id, app);
+
+    if (hidden || g_strcmp0(type, "Application") != 0 || !name ||
+        (!exec && !g_key_file_get_boolean(keyfile, DESKTOP_GROUP, "DBusActivatable", NULL))) {
+        app->entry.flags = G_MAXUINT32;
+        goto out;
+    }
+
+    icon = get_icon_name(keyfile);
+    names = get_localized_names(keyfile);
+    only_show_in = get_list(keyfile, "OnlyShowIn");
+    not_show_in = get_list(keyfile, "NotShowIn");
+
+    app->entry.id = add_string(strings, id);
+    app->entry.name = add_string(strings, name);
+    app->entry.localized_names = add_pairs(strings, names);
+    app->entry.exec = add_string(strings, exec);
+    app->entry.try_exec = add_string(strings, try_exec);
+    app->entry.icon = add_string(strings, icon);
+    app->entry.path = add_string(strings, path);
+    app->entry.only_show_in = add_string(strings, only_show_in);
+    app->entry.not_show_in = add_string(strings, not_show_in);
+    if (g_key_file_get_boolean(keyfile, DESKTOP_GROUP, "NoDisplay", NULL))
+        app->entry.flags |= CATALOG_ENTRY_NO_DISPLAY;
+
+    g_free(icon);
+    g_string_free(names, TRUE);
+    g_free(only_show_in);
+    g_free(not_show_in);
+
+out:
+    g_free(type);
+    g_free(name);
+    g_free(exec);
+    g_free(try_exec);
+    g_key_file_free(keyfile);
+    return TRUE;
+}
+
+/* Desktop ids of subdirectories are prefixed with the directory, e.g. kde4-foo.desktop */
+static void index_directory(GHashTable *apps, GString *strings, const gchar *dir, const gchar *prefix) {
+    GDir *handle = g_dir_open(dir, 0, NULL);
+    const gchar *filename;
+
+    if (!handle)
+        return;
+
+    while ((filename = g_dir_read_name(handle)) != NULL) {
+        gchar *path = g_build_filename(dir, filename, NULL);
+
+        if (g_file_test(path, G_FILE_TEST_IS_DIR)) {
+            gchar *sub_prefix = g_strconcat(prefix, filename, "-", NULL);
+            index_directory(apps, strings, path, sub_prefix);
+            g_free(sub_prefix);
+        } else if (g_str_has_suffix(filename, ".desktop")) {
+            gchar *id = g_strconcat(prefix, filename, NULL);
+
+            /* The first directory in the path wins */
+            if (!g_hash_table_contains(apps, id))
+                index_file(apps, strings, path, id);
+            g_free(id);
+        }
+        g_free(path);
+    }
+
+    g_dir_close(handle);
+}
+
+static gint compare_ids(gconstpointer a, gconstpointer b) {
+    const IndexedApp *app_a = *(const IndexedApp **)a;
+    const IndexedApp *app_b = *(const IndexedApp **)b;
+
+    return strcmp(app_a->id, app_b->id);
+}
+
+static void indexed_app_free(IndexedApp *app) {
+    g_free(app);
+}
+
+int main(int argc, char **argv) {
+    const gchar *dirs[] = SYSTEM_CATALOG_DIRS;
+    const gchar *output = SYSTEM_CATALOG_PATH;
+    GHashTable *apps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                             (GDestroyNotify)indexed_app_free);
+    GString *strings = g_string_new(NULL);
+    GString *file = g_string_new(NULL);
+    GPtrArray *sorted = g_ptr_array_new();
+    GHashTableIter iter;
+    CatalogHeader header;
+    GError *error = NULL;
+    IndexedApp *app;
+    gchar *dir;
+    guint i;
+
+    if (argc == 3 && strcmp(argv[1], "--output") == 0) {
+        output = argv[2];
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [--output FILE]\n", argv[0]);
+        return 2;
+    }
+
+    /* Offset 0 is the empty string */
+    g_string_append_c(strings, '\0');
+
+    for (i = 0; dirs[i] != NULL; i++)
+        index_directory(apps, strings, dirs[i], "");
+
+    /* Masked and unusable entries only kept their id from showing up again */
+    g_hash_table_iter_init(&iter, apps);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&app)) {
+        if (app->entry.flags != G_MAXUINT32)
+            g_ptr_array_add(sorted, app);
+    }
+    g_ptr_array_sort(sorted, compare_ids);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SYSTEM_CATALOG_MAGIC, 4);
+    header.version = SYSTEM_CATALOG_VERSION;
+    header.n_entries = sorted->len;
+    header.strings_offset = sizeof(CatalogHeader) + sorted->len * sizeof(CatalogEntry);
+    header.strings_size = strings->len;
+    header.generated = g_get_real_time() / G_USEC_PER_SEC;
+
+    g_string_append_len(file, (const gchar *)&header, sizeof(header));
+    for (i = 0; i < sorted->len; i++) {
+        app = g_ptr_array_index(sorted, i);
+        g_string_append_len(file, (const gchar *)&app->entry, sizeof(CatalogEntry));
+    }
+    g_string_append_len(file, strings->str, strings->len);
+
+    /* Replaced atomically, running panels keep the mapping of the old file */
+    dir = g_path_get_dirname(output);
+    g_mkdir_with_parents(dir, 0755);
+    g_free(dir);
+    if (!g_file_set_contents(output, file->str, file->len, &error)) {
+        fprintf(stderr, "xfce-launcher-index: %s\n", error->message);
+        g_error_free(error);
+        return 1;
+    }
+    g_chmod(output, 0644);
+
+    printf("xfce-launcher-index: %u applications written to %s\n", sorted->len, output);
+
+    g_ptr_array_free(sorted, TRUE);
+    g_string_free(file, TRUE);
+    g_string_free(strings, TRUE);
+    g_hash_table_destroy(apps);
+    return 0;
+}
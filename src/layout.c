@@ -0,0 +1,140 @@
+/*
+ * Grid layout for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <string.h>
+
+/* Tile size on a 1080p monitor, tiles scale with the logical monitor height */
+#define REFERENCE_HEIGHT 1080
+#define REFERENCE_BUTTON_SIZE 130
+#define REFERENCE_ICON_SIZE 64
+#define MIN_BUTTON_SIZE 110
+#define MAX_BUTTON_SIZE 200
+
+/* Share of the workarea width the grid may use */
+#define GRID_WIDTH_PERCENT 55
+/* Height taken by the search box and the page dots */
+#define OVERLAY_CHROME_HEIGHT 220
+
+#define MIN_COLUMNS 3
+#define MAX_COLUMNS 12
+#define MIN_ROWS 2
+#define MAX_ROWS 8
+
+/* A cached layout and the monitor state it was computed for */
+typedef struct {
+    GridLayout   layout;
+    GdkRectangle workarea;
+    gint         height;
+} CachedLayout;
+
+static void compute_layout(GridLayout *layout, const GdkRectangle *workarea, gint height, gint scale) {
+    gint avail_width, avail_height;
+
+    layout->scale = scale;
+    layout->button_size = CLAMP(height * REFERENCE_BUTTON_SIZE / REFERENCE_HEIGHT,
+                                MIN_BUTTON_SIZE, MAX_BUTTON_SIZE);
+    /* Icons keep their share of the tile, snapped to a multiple of 8 */
+    layout->icon_size = layout->button_size * REFERENCE_ICON_SIZE / REFERENCE_BUTTON_SIZE / 8 * 8;
+    layout->pitch = layout->button_size + 2 * TILE_MARGIN + TILE_SPACING;
+
+    /* The last tile has no trailing spacing */
+    avail_width = workarea->width * GRID_WIDTH_PERCENT / 100 + TILE_SPACING;
+    avail_height = workarea->height - OVERLAY_CHROME_HEIGHT + TILE_SPACING;
+    layout->columns = CLAMP(avail_width / layout->pitch, MIN_COLUMNS, MAX_COLUMNS);
+    layout->rows = CLAMP(avail_height / layout->pitch, MIN_ROWS, MAX_ROWS);
+    layout->apps_per_page = layout->columns * layout->rows;
+}
+
+static void on_monitor_removed(GdkDisplay *display, GdkMonitor *monitor, LauncherPlugin *launcher) {
+    g_hash_table_remove(launcher->layout_cache, monitor);
+}
+
+/* Monitor holding the panel button, the overlay opens there */
+GdkMonitor* layout_get_monitor(LauncherPlugin *launcher) {
+    GdkDisplay *display = gtk_widget_get_display(launcher->button);
+    GdkWindow *window = gtk_widget_get_window(launcher->button);
+    GdkMonitor *monitor = NULL;
+
+    if (window)
+        monitor = gdk_display_get_monitor_at_window(display, window);
+    if (!monitor)
+        monitor = gdk_display_get_primary_monitor(display);
+    if (!monitor)
+        monitor = gdk_display_get_monitor(display, 0);
+
+    return monitor;
+}
+
+/*
+ * Pick the layout for a monitor, computed once per monitor and redone only
+ * when its workarea or scale changed. Returns TRUE when the grid has to be
+ * laid out again.
+ */
+gboolean layout_update(LauncherPlugin *launcher, GdkMonitor *monitor) {
+    CachedLayout fallback = { { 0 } };
+    GdkRectangle workarea, geometry;
+    CachedLayout *cached;
+    gint scale;
+
+    if (!launcher->layout_cache) {
+        launcher->layout_cache = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+        g_signal_connect(gtk_widget_get_display(launcher->button), "monitor-removed",
+                         G_CALLBACK(on_monitor_removed), launcher);
+    }
+
+    if (monitor) {
+        gdk_monitor_get_workarea(monitor, &workarea);
+        gdk_monitor_get_geometry(monitor, &geometry);
+        scale = gdk_monitor_get_scale_factor(monitor);
+
+        cached = g_hash_table_lookup(launcher->layout_cache, monitor);
+        if (!cached) {
+            cached = g_new0(CachedLayout, 1);
+            g_hash_table_insert(launcher->layout_cache, monitor, cached);
+        }
+    } else {
+        /* No monitor known yet, lay out for the reference size */
+        workarea.x = workarea.y = 0;
+        workarea.width = 1920;
+        workarea.height = REFERENCE_HEIGHT;
+        geometry = workarea;
+        scale = 1;
+        cached = &fallback;
+    }
+
+    if (cached->layout.apps_per_page == 0 || !gdk_rectangle_equal(&cached->workarea, &workarea) ||
+        cached->height != geometry.height || cached->layout.scale != scale) {
+        cached->workarea = workarea;
+        cached->height = geometry.height;
+        compute_layout(&cached->layout, &workarea, geometry.height, scale);
+
+        g_debug("Layout: %dx%d tiles of %dpx, icons %dpx, scale %d",
+                cached->layout.columns, cached->layout.rows,
+                cached->layout.button_size, cached->layout.icon_size, scale);
+    }
+
+    if (memcmp(&cached->layout, &launcher->layout, sizeof(GridLayout)) == 0)
+        return FALSE;
+
+    launcher->layout = cached->layout;
+    invalidate_page_index(launcher);
+    if (launcher->drawn_grid && launcher->app_grid)
+        tile_grid_layout_changed(launcher->app_grid);
+
+    return TRUE;
+}
+
+void layout_free(LauncherPlugin *launcher) {
+    if (launcher->layout_cache) {
+        g_signal_handlers_disconnect_by_func(gtk_widget_get_display(launcher->button),
+                                             on_monitor_removed, launcher);
+        g_hash_table_destroy(launcher->layout_cache);
+        launcher->layout_cache = NULL;
+    }
+}
@@ -0,0 +1,199 @@
+/*
+ * Keyboard navigation for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+
+/*
+ * The selection is an index into the page index, not a widget, so moving
+ * it only restyles two tiles. Pages are only switched when the selection
+ * crosses a page boundary.
+ */
+
+/* Tile of the widget grid showing a page-local index, NULL while it is still being built */
+static GtkWidget* get_widget_tile(LauncherPlugin *launcher, gint local) {
+    return gtk_grid_get_child_at(GTK_GRID(launcher->app_grid),
+                                 local % launcher->layout.columns,
+                                 local / launcher->layout.columns);
+}
+
+/* Index of a tile on the page shown, -1 when it is on another page */
+static gint get_local_index(LauncherPlugin *launcher, gint index) {
+    gint local = index - page_index_get_page_start(launcher, launcher->current_page);
+    gint count;
+
+    page_index_get_page(launcher, launcher->current_page, &count);
+    return index >= 0 && local >= 0 && local < count ? local : -1;
+}
+
+static void set_tile_selected(LauncherPlugin *launcher, gint index, gboolean selected) {
+    gint local = get_local_index(launcher, index);
+    GtkWidget *tile;
+
+    if (local < 0)
+        return;
+
+    tile = get_widget_tile(launcher, local);
+    if (!tile)
+        return;
+
+    if (selected)
+        gtk_widget_set_state_flags(tile, GTK_STATE_FLAG_SELECTED, FALSE);
+    else
+        gtk_widget_unset_state_flags(tile, GTK_STATE_FLAG_SELECTED);
+}
+
+/* Highlight the selection on the page shown, called after a page was (re)built */
+void selection_show(LauncherPlugin *launcher) {
+    gint local = get_local_index(launcher, launcher->selected_index);
+
+    if (launcher->drawn_grid)
+        tile_grid_set_selection(launcher->app_grid, local);
+    else
+        set_tile_selected(launcher, launcher->selected_index, TRUE);
+}
+
+/* Move the selection to a global index, -1 clears it */
+void selection_set(LauncherPlugin *launcher, gint index) {
+    gint count = page_index_get_item_count(launcher);
+    gint page;
+
+    if (count == 0)
+        index = -1;
+    else if (index >= count)
+        index = count - 1;
+
+    if (!launcher->drawn_grid)
+        set_tile_selected(launcher, launcher->selected_index, FALSE);
+    launcher->selected_index = index;
+
+    /* Crossing a page goes through the page cache and transitions of show_page */
+    if (index >= 0) {
+        page = page_index_find_page(launcher, index);
+        if (page != launcher->current_page)
+            show_page(launcher, page);
+    }
+
+    selection_show(launcher);
+}
+
+static void activate_item(LauncherPlugin *launcher, gint index) {
+    gint page = page_index_find_page(launcher, index);
+    gint local = index - page_index_get_page_start(launcher, page);
+    GridItem *items;
+    GridItem item;
+    gint count;
+
+    items = page_index_get_page(launcher, page, &count);
+    if (local < 0 || local >= count)
+        return;
+
+    /* Copy the item, activating a folder replaces the page index */
+    item = items[local];
+    if (item.app_info)
+        launch_application(launcher->overlay_window, item.app_info);
+    else if (item.folder_info)
+        on_folder_clicked(launcher->overlay_window, item.folder_info);
+}
+
+/* Arrow keys, Page Up/Down, Home/End and Enter, returns TRUE when the key was used */
+gboolean navigation_handle_key(LauncherPlugin *launcher, GdkEventKey *event) {
+    gint columns = launcher->layout.columns;
+    gint pages = page_index_get_page_count(launcher);
+    gint count = page_index_get_item_count(launcher);
+    gint index = launcher->selected_index;
+    gint page, local, page_start, page_count, other_start, other_count;
+
+    if (count == 0)
+        return FALSE;
+
+    /* The first key press only reveals the selection on the page shown */
+    if (index < 0) {
+        switch (event->keyval) {
+            case GDK_KEY_Left:
+            case GDK_KEY_Right:
+            case GDK_KEY_Up:
+            case GDK_KEY_Down:
+                selection_set(launcher, page_index_get_page_start(launcher, launcher->current_page));
+                return TRUE;
+            case GDK_KEY_Return:
+            case GDK_KEY_KP_Enter:
+                /* Nothing selected: the top result */
+                activate_item(launcher, page_index_get_page_start(launcher, launcher->current_page));
+                return TRUE;
+            default:
+                break;
+        }
+    }
+
+    /* Pages differ in length, the "Frequent" page is usually a short one.
+     * Without a selection, e.g. after a scroll, keys act on the page shown */
+    page = index < 0 ? launcher->current_page : page_index_find_page(launcher, index);
+    page_start = page_index_get_page_start(launcher, page);
+    page_index_get_page(launcher, page, &page_count);
+    local = index < 0 ? 0 : index - page_start;
+
+    switch (event->keyval) {
+        case GDK_KEY_Left:
+            index = MAX(index - 1, 0);
+            break;
+        case GDK_KEY_Right:
+            index = MIN(index + 1, count - 1);
+            break;
+        case GDK_KEY_Up:
+            /* From the top row to the bottom row of the previous page */
+            if (local >= columns) {
+                index -= columns;
+            } else if (page > 0) {
+                other_start = page_index_get_page_start(launcher, page - 1);
+                page_index_get_page(launcher, page - 1, &other_count);
+                index = other_start + MIN((other_count - 1) / columns * columns + local,
+                                          other_count - 1);
+            }
+            break;
+        case GDK_KEY_Down:
+            /* From the bottom row to the top row of the next page */
+            if (local + columns < page_count) {
+                index += columns;
+            } else if (page + 1 < pages) {
+                other_start = page_index_get_page_start(launcher, page + 1);
+                page_index_get_page(launcher, page + 1, &other_count);
+                index = other_start + MIN(local % columns, other_count - 1);
+            }
+            break;
+        case GDK_KEY_Page_Up:
+            if (page == 0)
+                return TRUE;
+            other_start = page_index_get_page_start(launcher, page - 1);
+            page_index_get_page(launcher, page - 1, &other_count);
+            index = other_start + MIN(local, other_count - 1);
+            break;
+        case GDK_KEY_Page_Down:
+            if (page + 1 >= pages)
+                return TRUE;
+            other_start = page_index_get_page_start(launcher, page + 1);
+            page_index_get_page(launcher, page + 1, &other_count);
+            index = other_start + MIN(local, other_count - 1);
+            break;
+        case GDK_KEY_Home:
+            index = 0;
+            break;
+        case GDK_KEY_End:
+            index = count - 1;
+            break;
+        case GDK_KEY_Return:
+        case GDK_KEY_KP_Enter:
+            activate_item(launcher, index);
+            return TRUE;
+        default:
+            return FALSE;
+    }
+
+    if (index != launcher->selected_index)
+        selection_set(launcher, index);
+    return TRUE;
+}
@@ -0,0 +1,305 @@
+/*
+ * Per-monitor overlay instances for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <string.h>
+
+/* Hidden overlays unused for this long go first under light memory pressure */
+#define OVERLAY_IDLE_US (60 * G_USEC_PER_SEC)
+
+/*
+ * Every monitor gets its own overlay, laid out and rendered for that
+ * monitor's size and scale. The instance in use is swapped into the
+ * LauncherPlugin fields, so the rest of the code works on "the" overlay.
+ */
+struct _OverlayInstance {
+    GdkMonitor  *monitor;
+    GtkWidget   *overlay_window;
+    GtkWidget   *search_entry;
+    GtkWidget   *back_button;
+    GtkWidget   *grid_container;
+    GtkWidget   *app_grid;
+    GtkWidget   *page_dots;
+    GridLayout  layout;
+    gint        shown_page;
+    gboolean    page_dirty;
+    gint64      last_used;
+};
+
+static void save_instance(LauncherPlugin *launcher, OverlayInstance *instance) {
+    instance->overlay_window = launcher->overlay_window;
+    instance->search_entry = launcher->search_entry;
+    instance->back_button = launcher->back_button;
+    instance->grid_container = launcher->grid_container;
+    instance->app_grid = launcher->app_grid;
+    instance->page_dots = launcher->page_dots;
+    instance->layout = launcher->layout;
+    instance->shown_page = launcher->shown_page;
+    instance->page_dirty = launcher->page_dirty;
+}
+
+static void load_instance(LauncherPlugin *launcher, OverlayInstance *instance) {
+    gboolean layout_changed = memcmp(&launcher->layout, &instance->layout, sizeof(GridLayout)) != 0;
+
+    launcher->overlay_window = instance->overlay_window;
+    launcher->search_entry = instance->search_entry;
+    launcher->back_button = instance->back_button;
+    launcher->grid_container = instance->grid_container;
+    launcher->app_grid = instance->app_grid;
+    launcher->page_dots = instance->page_dots;
+    launcher->layout = instance->layout;
+    launcher->shown_page = instance->shown_page;
+    launcher->page_dirty = instance->page_dirty;
+    launcher->overlay = instance;
+
+    if (!launcher->overlay_window)
+        return;
+
+    /* The page index is shared, it was split for the previous overlay's grid */
+    if (layout_changed)
+        invalidate_page_index(launcher);
+
+    /* The grid mode may have been switched while this overlay was not in use */
+    if ((g_object_get_data(G_OBJECT(launcher->app_grid), "tile-grid") != NULL) != launcher->drawn_grid) {
+        create_app_grid(launcher);
+        launcher->page_dirty = TRUE;
+    }
+
+    if (launcher->open_folder)
+        gtk_widget_show(launcher->back_button);
+    else
+        gtk_widget_hide(launcher->back_button);
+}
+
+static void free_instance(OverlayInstance *instance) {
+    if (instance->overlay_window)
+        gtk_widget_destroy(instance->overlay_window);
+    g_free(instance);
+}
+
+static gint get_monitor_num(GdkMonitor *monitor) {
+    GdkDisplay *display = gdk_monitor_get_display(monitor);
+    gint i, n_monitors = gdk_display_get_n_monitors(display);
+
+    for (i = 0; i < n_monitors; i++) {
+        if (gdk_display_get_monitor(display, i) == monitor)
+            return i;
+    }
+    return -1;
+}
+
+/* Drop the icon tiers no remaining drawn overlay renders at */
+static void trim_icon_tiers(LauncherPlugin *launcher) {
+    GHashTableIter iter;
+    OverlayInstance *instance;
+    GHashTable *used;
+    gpointer key;
+
+    if (!launcher->icon_tiers)
+        return;
+
+    used = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_hash_table_iter_init(&iter, launcher->overlays);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&instance)) {
+        const GridLayout *layout = instance == launcher->overlay ? &launcher->layout : &instance->layout;
+        g_hash_table_add(used, GINT_TO_POINTER(layout->scale << 16 | layout->icon_size));
+    }
+
+    g_hash_table_iter_init(&iter, launcher->icon_tiers);
+    while (g_hash_table_iter_next(&iter, &key, NULL)) {
+        if (!g_hash_table_contains(used, key))
+            g_hash_table_iter_remove(&iter);
+    }
+    g_hash_table_destroy(used);
+}
+
+/* Release the overlays idle for at least min_idle, never the one in use */
+static void evict_idle_instances(LauncherPlugin *launcher, gint64 min_idle) {
+    GHashTableIter iter;
+    OverlayInstance *instance;
+    gint64 now = g_get_monotonic_time();
+    guint evicted = 0;
+
+    g_hash_table_iter_init(&iter, launcher->overlays);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&instance)) {
+        if (instance != launcher->overlay && now - instance->last_used >= min_idle) {
+            g_hash_table_iter_remove(&iter);
+            evicted++;
+        }
+    }
+
+    trim_icon_tiers(launcher);
+    g_debug("Overlay: evicted %u idle instances", evicted);
+}
+
+#if GLIB_CHECK_VERSION(2, 64, 0)
+static void on_low_memory_warning(GMemoryMonitor *monitor, GMemoryMonitorWarningLevel level,
+                                  LauncherPlugin *launcher) {
+    evict_idle_instances(launcher, level >= G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM ? 0 : OVERLAY_IDLE_US);
+}
+#endif
+
+static void on_monitor_removed(GdkDisplay *display, GdkMonitor *monitor, LauncherPlugin *launcher) {
+    OverlayInstance *instance = g_hash_table_lookup(launcher->overlays, monitor);
+
+    if (!instance)
+        return;
+
+    /* The overlay in use moves to the panel's monitor */
+    if (instance == launcher->overlay) {
+        hide_overlay(launcher);
+        save_instance(launcher, instance);
+        launcher->overlay = NULL;
+        g_hash_table_remove(launcher->overlays, monitor);
+        overlay_select(launcher, layout_get_monitor(launcher));
+    } else {
+        g_hash_table_remove(launcher->overlays, monitor);
+    }
+}
+
+/* Monitor to open on: the one holding the pointer, else the panel's */
+GdkMonitor* overlay_get_target_monitor(LauncherPlugin *launcher) {
+    GdkDisplay *display = gtk_widget_get_display(launcher->button);
+    GdkSeat *seat = gdk_display_get_default_seat(display);
+    GdkDevice *pointer = seat ? gdk_seat_get_pointer(seat) : NULL;
+    GdkMonitor *monitor = NULL;
+    gint x, y;
+
+    if (pointer) {
+        gdk_device_get_position(pointer, NULL, &x, &y);
+        monitor = gdk_display_get_monitor_at_point(display, x, y);
+    }
+
+    return monitor ? monitor : layout_get_monitor(launcher);
+}
+
+/* Monitor of the overlay in use */
+GdkMonitor* overlay_get_monitor(LauncherPlugin *launcher) {
+    return launcher->overlay ? launcher->overlay->monitor : layout_get_monitor(launcher);
+}
+
+/* Make the overlay of a monitor the one in use, creating it on first use */
+void overlay_select(LauncherPlugin *launcher, GdkMonitor *monitor) {
+    OverlayInstance *instance;
+
+    if (!launcher->overlays) {
+        launcher->overlays = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                   (GDestroyNotify)free_instance);
+        g_signal_connect(gtk_widget_get_display(launcher->button), "monitor-removed",
+                         G_CALLBACK(on_monitor_removed), launcher);
+#if GLIB_CHECK_VERSION(2, 64, 0)
+        launcher->memory_monitor = G_OBJECT(g_memory_monitor_dup_default());
+        if (launcher->memory_monitor)
+            g_signal_connect(launcher->memory_monitor, "low-memory-warning",
+                             G_CALLBACK(on_low_memory_warning), launcher);
+#endif
+    }
+
+    instance = g_hash_table_lookup(launcher->overlays, monitor);
+    if (instance && instance == launcher->overlay) {
+        instance->last_used = g_get_monotonic_time();
+        return;
+    }
+
+    if (launcher->overlay) {
+        if (gtk_widget_get_visible(launcher->overlay_window))
+            hide_overlay(launcher);
+        /* A page still being built belongs to the outgoing grid */
+        page_build_cancel(launcher);
+        save_instance(launcher, launcher->overlay);
+    }
+
+    if (!instance) {
+        instance = g_new0(OverlayInstance, 1);
+        instance->monitor = monitor;
+        instance->layout = launcher->layout;
+        g_hash_table_insert(launcher->overlays, monitor, instance);
+    }
+
+    instance->last_used = g_get_monotonic_time();
+    load_instance(launcher, instance);
+
+    if (!launcher->overlay_window) {
+        create_overlay_window(launcher);
+        save_instance(launcher, instance);
+    }
+}
+
+/* Fullscreen the overlay window on its own monitor */
+void overlay_fullscreen(LauncherPlugin *launcher) {
+    gint monitor_num = launcher->overlay ? get_monitor_num(launcher->overlay->monitor) : -1;
+
+    if (monitor_num >= 0)
+        gtk_window_fullscreen_on_monitor(GTK_WINDOW(launcher->overlay_window),
+                                         gtk_widget_get_screen(launcher->overlay_window), monitor_num);
+    else
+        gtk_window_fullscreen(GTK_WINDOW(launcher->overlay_window));
+}
+
+/* Icons decoded for one scale and size, shared by the overlays rendering at it */
+GHashTable* overlay_get_icon_tier(LauncherPlugin *launcher, gint scale, gint icon_size) {
+    gpointer key = GINT_TO_POINTER(scale << 16 | icon_size);
+    GHashTable *icons;
+
+    /* The tiers themselves live in the catalog, other launchers may render at the same size */
+    if (!launcher->icon_tiers)
+        launcher->icon_tiers = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                                     catalog_release_icon_tier, NULL);
+
+    icons = g_hash_table_lookup(launcher->icon_tiers, key);
+    if (!icons) {
+        icons = catalog_acquire_icon_tier(key);
+        g_hash_table_insert(launcher->icon_tiers, key, icons);
+    }
+
+    return icons;
+}
+
+/* Mark the pages of every overlay stale, not only the one in use */
+void overlay_invalidate_all(LauncherPlugin *launcher) {
+    GHashTableIter iter;
+    OverlayInstance *instance;
+
+    if (!launcher->overlays)
+        return;
+
+    g_hash_table_iter_init(&iter, launcher->overlays);
+    while (g_hash_table_iter_next(&iter, NULL, (gpointer *)&instance)) {
+        instance->page_dirty = TRUE;
+
+        /* The tiles of the other overlays may point at apps about to be
+         * freed; dropping them also defuncts their accessible children */
+        if (instance != launcher->overlay && instance->app_grid &&
+            g_object_get_data(G_OBJECT(instance->app_grid), "tile-grid"))
+            tile_grid_set_items(instance->app_grid, NULL, 0);
+    }
+}
+
+void overlay_free(LauncherPlugin *launcher) {
+    if (launcher->overlay)
+        save_instance(launcher, launcher->overlay);
+    launcher->overlay = NULL;
+    launcher->overlay_window = NULL;
+
+    if (launcher->overlays) {
+        g_signal_handlers_disconnect_by_func(gtk_widget_get_display(launcher->button),
+                                             on_monitor_removed, launcher);
+        g_hash_table_destroy(launcher->overlays);
+        launcher->overlays = NULL;
+    }
+    if (launcher->icon_tiers) {
+        g_hash_table_destroy(launcher->icon_tiers);
+        launcher->icon_tiers = NULL;
+    }
+#if GLIB_CHECK_VERSION(2, 64, 0)
+    if (launcher->memory_monitor) {
+        g_signal_handlers_disconnect_by_func(launcher->memory_monitor, on_low_memory_warning, launcher);
+        g_clear_object(&launcher->memory_monitor);
+    }
+#endif
+}
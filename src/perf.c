@@ -0,0 +1,136 @@
+/*
+ * Performance instrumentation for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+
+void perf_counter_add(PerfCounter *counter, gint64 usec) {
+    counter->count++;
+    counter->total_us += usec;
+    if (usec > counter->max_us)
+        counter->max_us = usec;
+}
+
+void perf_counter_reset(PerfCounter *counter) {
+    counter->count = 0;
+    counter->total_us = 0;
+    counter->max_us = 0;
+}
+
+void perf_counter_report(const PerfCounter *counter, const gchar *label) {
+    if (counter->count == 0)
+        return;
+
+    g_debug("%s: %u samples, avg %.2f ms, max %.2f ms",
+            label, counter->count,
+            (gdouble)counter->total_us / counter->count / 1000.0,
+            (gdouble)counter->max_us / 1000.0);
+}
+
+/* Frame clock callbacks */
+static void on_before_paint(GdkFrameClock *clock, LauncherPlugin *launcher) {
+    if (!launcher->tracing)
+        return;
+
+    launcher->frame_start = g_get_monotonic_time();
+}
+
+static void on_after_paint(GdkFrameClock *clock, LauncherPlugin *launcher) {
+    gint64 now;
+
+    if (!launcher->tracing)
+        return;
+
+    now = g_get_monotonic_time();
+    if (launcher->frame_start != 0) {
+        perf_counter_add(&launcher->frame_time, now - launcher->frame_start);
+        launcher->frame_start = 0;
+    }
+
+    /* First frame after a click on the panel button */
+    if (launcher->open_time != 0) {
+        perf_counter_add(&launcher->open_latency, now - launcher->open_time);
+        g_debug("Click to first frame: %.2f ms", (now - launcher->open_time) / 1000.0);
+        launcher->open_time = 0;
+    }
+}
+
+static void on_window_realize(GtkWidget *window, LauncherPlugin *launcher) {
+    GdkFrameClock *clock = gtk_widget_get_frame_clock(window);
+
+    if (clock) {
+        g_signal_connect(clock, "before-paint", G_CALLBACK(on_before_paint), launcher);
+        g_signal_connect(clock, "after-paint", G_CALLBACK(on_after_paint), launcher);
+    }
+}
+
+/* Measure paint time of every frame the overlay renders */
+void perf_watch_frames(LauncherPlugin *launcher, GtkWidget *window) {
+    g_signal_connect(window, "realize", G_CALLBACK(on_window_realize), launcher);
+}
+
+/* Report and reset the counters collected while the overlay was shown */
+void perf_report_overlay(LauncherPlugin *launcher) {
+    if (!launcher->tracing)
+        return;
+
+    perf_counter_report(&launcher->frame_time,
+                        launcher->drawn_grid ? "Frame time (drawn grid)" : "Frame time (widget grid)");
+    perf_counter_report(&launcher->tile_draw_time, "Tile grid draw");
+    perf_counter_report(&launcher->label_shape_time, "Label shaping per draw");
+    perf_counter_report(&launcher->open_latency, "Click to first frame");
+    perf_counter_report(&launcher->launch_latency, "Launch click to overlay hidden");
+    perf_counter_report(&launcher->search_time, "Search");
+    g_debug("Hot standby: %u opens reused the standby page, %u rebuilt it",
+            launcher->standby_hits, launcher->standby_misses);
+    g_debug("Warm-up: %u started, %u completed, %u cancelled, %u used by a click",
+            launcher->warmup_started, launcher->warmup_completed,
+            launcher->warmup_cancelled, launcher->warmup_used);
+
+    perf_report_configuration(launcher);
+
+    perf_counter_reset(&launcher->frame_time);
+    perf_counter_reset(&launcher->tile_draw_time);
+    perf_counter_reset(&launcher->label_shape_time);
+    perf_counter_reset(&launcher->search_time);
+}
+
+/* Saves requested against snapshots taken, files written and journal appends; the writer updates its part */
+void perf_report_configuration(LauncherPlugin *launcher) {
+    if (launcher->config_save_requests > 0)
+        g_debug("Config: %u snapshot saves requested, %u taken",
+                launcher->config_save_requests, launcher->config_snapshot_time.count);
+    perf_counter_report(&launcher->config_snapshot_time, "Config snapshot");
+
+    g_mutex_lock(&launcher->config_lock);
+    perf_counter_report(&launcher->config_write_time, "Config write");
+    perf_counter_report(&launcher->config_journal_time, "Config journal append");
+    if (launcher->config_write_failures > 0)
+        g_debug("Config: %u writes failed", launcher->config_write_failures);
+    g_mutex_unlock(&launcher->config_lock);
+}
+
+#if GLIB_CHECK_VERSION(2, 72, 0)
+/* Debug output belongs to the whole panel, it is put back once no launcher traces */
+static guint tracing_users;
+static gboolean debug_was_enabled;
+#endif
+
+/* Frame timing and the reports above, debug messages are shown while it is on */
+void perf_set_tracing(LauncherPlugin *launcher, gboolean tracing) {
+#if GLIB_CHECK_VERSION(2, 72, 0)
+    if (tracing && !launcher->tracing && tracing_users++ == 0) {
+        debug_was_enabled = g_log_get_debug_enabled();
+        g_log_set_debug_enabled(TRUE);
+    } else if (!tracing && launcher->tracing && --tracing_users == 0) {
+        g_log_set_debug_enabled(debug_was_enabled);
+    }
+#endif
+    launcher->tracing = tracing;
+    launcher->frame_start = 0;
+    launcher->open_time = 0;
+}
@@ -31,6 +31,9 @@ XFCE_PANEL_PLUGIN_REGISTER(launcher_construct);
 /* Plugin construction */
 static void launcher_construct(XfcePanelPlugin *plugin) {
     LauncherPlugin *launcher;
+    GThread *config_parser = NULL;
+    gint64 load_start;
+    gboolean serial;
     
     /* Allocate memory for the plugin structure */
     launcher = g_slice_new0(LauncherPlugin);
@@ -43,44 +46,8 @@ static void launcher_construct(XfcePanelPlugin *plugin) {
     gtk_widget_show(launcher->button);
     
     /* Make panel button transparent */
-    GtkCssProvider *button_provider = gtk_css_provider_new();
-    gtk_css_provider_load_from_data(button_provider,
-        "#xfce-launcher-button {\n"
-        "  background: transparent;\n"
-        "  background-color: transparent;\n"
-        "  background-image: none;\n"
-        "  border: none;\n"
-        "  outline: none;\n"
-        "  padding: 0px;\n"
-        "  margin: 0px;\n"
-        "  min-width: 16px;\n"
-        "  min-height: 16px;\n"
-        "}\n"
-        "#xfce-launcher-button:hover {\n"
-        "  background-color: rgba(255, 255, 255, 0.1);\n"
-        "  background-image: none;\n"
-        "}\n"
-        "#xfce-launcher-button:active {\n"
-        "  background-color: rgba(255, 255, 255, 0.2);\n"
-        "  background-image: none;\n"
-        "}\n"
-        ".xfce4-panel #xfce-launcher-button {\n"
-        "  background: transparent;\n"
-        "  background-color: transparent;\n"
-        "}\n",
-        -1,
-        NULL);
-    
-    GdkScreen *screen = gtk_widget_get_screen(launcher->button);
-    gtk_style_context_add_provider_for_screen(screen,
-                                             GTK_STYLE_PROVIDER(button_provider),
-                                             GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
-    
-    GtkStyleContext *button_context = gtk_widget_get_style_context(launcher->button);
-    gtk_style_context_add_provider(button_context,
-                                   GTK_STYLE_PROVIDER(button_provider),
-                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
-    g_object_unref(button_provider);
+    theme_acquire();
+    theme_apply_button(launcher->button);
     
     /* Create icon */
     launcher->icon = gtk_image_new_from_icon_name("xfce-launcher", GTK_ICON_SIZE_BUTTON);
@@ -113,42 +80,67 @@ static void launcher_construct(XfcePanelPlugin *plugin) {
     /* Enable context menu for properties */
     xfce_panel_plugin_menu_show_configure(plugin);
     
-    /* Load applications */
-    g_list_free_full(launcher->app_list, (GDestroyNotify)free_app_info);
-    launcher->app_list = load_applications_enhanced();
+    /* Parse the configuration while the applications are scanned,
+     * XFCE_LAUNCHER_SERIAL_STARTUP=1 does one after the other for comparison */
+    g_mutex_init(&launcher->config_lock);
+    launcher->config_path = get_config_file_path(xfce_panel_plugin_get_unique_id(plugin));
+    launcher->journal_path = get_journal_file_path(xfce_panel_plugin_get_unique_id(plugin));
+    load_start = g_get_monotonic_time();
+    serial = g_getenv("XFCE_LAUNCHER_SERIAL_STARTUP") != NULL;
+    if (!serial)
+        config_parser = load_configuration_begin(launcher);
+
+    /* Load applications, only the first launcher in the process scans them */
+    catalog_acquire(launcher);
+    launcher->app_list = catalog_new_view();
 
     /* Load configuration */
-    load_configuration(launcher);
+    if (serial)
+        load_configuration(launcher);
+    else
+        load_configuration_finish(launcher, config_parser);
+    g_debug("Startup: applications and configuration loaded in %.2f ms (%s)",
+            (g_get_monotonic_time() - load_start) / 1000.0, serial ? "serial" : "pipelined");
 
     launcher->filtered_list = g_list_copy(launcher->app_list);
     launcher->current_page = 0;
+    launcher->scroll.commit_frame = -1;
+    launcher->selected_index = -1;
+    launcher->launch_cancellable = g_cancellable_new();
     
-    /* Setup application monitoring for automatic refresh */
-    setup_application_monitoring(launcher);
-    
-    /* Create overlay window (hidden initially) */
-    create_overlay_window(launcher);
+    /* Start the process that spawns applications for us */
+    spawn_helper_start(launcher);
+    probe_init(launcher);
+    usage_init(launcher);
     
-    /* Store launcher reference in overlay window */
-    g_object_set_data(G_OBJECT(launcher->overlay_window), "launcher", launcher);
+    /* Create the overlay of the panel's monitor (hidden initially), others are created on demand */
+    overlay_select(launcher, layout_get_monitor(launcher));
     
-    /* Add swipe gesture for touchpad */
-    GtkGesture *swipe_gesture = gtk_gesture_swipe_new(launcher->overlay_window);
-    gtk_gesture_single_set_touch_only(GTK_GESTURE_SINGLE(swipe_gesture), FALSE);
-    g_signal_connect(swipe_gesture, "swipe",
-                     G_CALLBACK(on_swipe_gesture), launcher);
-    
-    /* Connect drag and drop signals on grid */
-    gtk_drag_dest_set(launcher->app_grid, GTK_DEST_DEFAULT_ALL, NULL, 0, GDK_ACTION_MOVE);
-    g_signal_connect(launcher->app_grid, "drag-drop",
-                     G_CALLBACK(on_drag_drop), launcher);
+    /* Warm up the overlay while the pointer rests on the button */
+    warmup_init(launcher);
 }
 
 /* Free plugin resources */
 static void launcher_free(XfcePanelPlugin *plugin, LauncherPlugin *launcher) {
-    /* Destroy overlay window */
-    if (launcher->overlay_window)
-        gtk_widget_destroy(launcher->overlay_window);
+    if (launcher->standby_source)
+        g_source_remove(launcher->standby_source);
+    warmup_cancel(launcher);
+    
+    /* Launches still being spawned finish without us */
+    g_cancellable_cancel(launcher->launch_cancellable);
+    g_clear_object(&launcher->launch_cancellable);
+    spawn_helper_stop(launcher);
+    probe_free(launcher);
+    usage_free(launcher);
+    
+    /* Changes of the last moments are still saved */
+    flush_configuration(launcher);
+    g_mutex_clear(&launcher->config_lock);
+    g_free(launcher->config_path);
+    g_free(launcher->journal_path);
+    
+    /* Destroy the overlay windows of all monitors */
+    overlay_free(launcher);
     
     /* Free application list */
     if (launcher->app_list) {
@@ -157,6 +149,10 @@ static void launcher_free(XfcePanelPlugin *plugin, LauncherPlugin *launcher) {
     if (launcher->filtered_list) {
         g_list_free(launcher->filtered_list);
     }
+    catalog_release(launcher);
+    page_index_free(launcher);
+    search_free(launcher);
+    layout_free(launcher);
     
     /* Free folder list */
     if (launcher->folder_list) {
@@ -165,6 +161,7 @@ static void launcher_free(XfcePanelPlugin *plugin, LauncherPlugin *launcher) {
     
     /* Free settings resources */
     launcher_settings_free(launcher);
+    theme_release();
     
     /* Free the plugin structure */
     g_slice_free(LauncherPlugin, launcher);
@@ -194,13 +191,39 @@ static void launcher_configure_plugin(XfcePanelPlugin *plugin, LauncherPlugin *l
 /* Handle button click */
 void launcher_button_clicked(GtkWidget *button, LauncherPlugin *launcher) {
     if (launcher->overlay_window) {
-        /* Reset to first page when opening */
+        gboolean warmed_up = launcher->warmup_ready;
+        GdkMonitor *monitor = overlay_get_target_monitor(launcher);
+        
+        launcher->open_time = g_get_monotonic_time();
+        
+        /* Open on the monitor the user is on, with that monitor's overlay */
+        if (overlay_get_monitor(launcher) != monitor) {
+            overlay_select(launcher, monitor);
+            warmed_up = FALSE;
+        }
+        warmup_note_open(launcher);
+        
+        if (launcher->standby_source) {
+            g_source_remove(launcher->standby_source);
+            launcher->standby_source = 0;
+        }
+        
+        /* Reset to first page when opening, a standby page is reused as is */
+        layout_update(launcher, overlay_get_monitor(launcher));
         launcher->current_page = 0;
-        populate_current_page(launcher);
-        update_page_dots(launcher);
+        if ((!launcher->hot_standby && !warmed_up) || launcher->page_dirty || launcher->shown_page != 0) {
+            populate_current_page(launcher);
+            update_page_dots(launcher);
+            launcher->standby_misses++;
+        } else {
+            launcher->standby_hits++;
+        }
         
-        gtk_widget_show_all(launcher->overlay_window);
         gtk_window_present(GTK_WINDOW(launcher->overlay_window));
         gtk_widget_grab_focus(launcher->search_entry);
+        
+        /* Read the likely next launch from disk while the user looks */
+        usage_prefetch_begin(launcher);
+        usage_prefetch_candidates(launcher);
     }
 }
@@ -0,0 +1,514 @@
+/*
+ * Launch latency probe for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <string.h>
+#include <gdk/gdkx.h>
+#include <X11/Xatom.h>
+
+/*
+ * Measures click to first mapped window per application. A launch is
+ * matched to a new top-level window by _NET_STARTUP_ID or _NET_WM_PID.
+ * New windows are seen through _NET_CLIENT_LIST under a window manager,
+ * and through MapNotify on the root window without one (e.g. Xvfb).
+ */
+
+/* Launches whose window never shows up are dropped after this */
+#define PROBE_TIMEOUT_US (60 * G_USEC_PER_SEC)
+#define PROBE_SWEEP_SECONDS 5
+/* Samples within this are saved together */
+#define STATS_SAVE_DELAY_SECONDS 2
+
+#define STATS_GROUP_HISTOGRAM "Histogram"
+#define STATS_KEY_TOTAL "TotalMs"
+#define STATS_KEY_TIMEOUTS "Timeouts"
+
+/* Upper bucket limits in ms, the last bucket is open ended */
+static const gint bucket_limits[] = { 100, 250, 500, 1000, 2000, 5000, 10000 };
+#define N_BUCKETS (G_N_ELEMENTS(bucket_limits) + 1)
+
+typedef struct {
+    gchar   *app_id;
+    gchar   *startup_id;
+    GPid    pid;
+    gint64  start;
+} ProbeLaunch;
+
+static void probe_launch_free(ProbeLaunch *launch) {
+    g_free(launch->app_id);
+    g_free(launch->startup_id);
+    g_free(launch);
+}
+
+/*
+ * The statistics are shared by the launchers of the process, so samples
+ * of one never overwrite those of another. Saving is debounced, the main
+ * thread only serializes the key file and a writer thread replaces the
+ * file, which may well be on NFS.
+ */
+static guint probe_users = 0;
+static GKeyFile *probe_stats = NULL;
+static guint probe_save_source = 0;
+static GThreadPool *probe_save_pool = NULL;
+
+static gchar* get_stats_path(void) {
+    return g_build_filename(g_get_user_cache_dir(), "xfce4", "launcher", "launch-latency.stats", NULL);
+}
+
+static GKeyFile* get_stats(void) {
+    gchar *path;
+
+    if (!probe_stats) {
+        probe_stats = g_key_file_new();
+        path = get_stats_path();
+        g_key_file_load_from_file(probe_stats, path, G_KEY_FILE_NONE, NULL);
+        g_free(path);
+    }
+    return probe_stats;
+}
+
+/* Runs on the writer thread, takes the serialized statistics */
+static void write_stats(gpointer data, gpointer user_data) {
+    gchar *contents = (gchar *)data;
+    GError *error = NULL;
+    gchar *path = get_stats_path();
+    gchar *dir = g_path_get_dirname(path);
+
+    g_mkdir_with_parents(dir, 0700);
+    if (!g_file_set_contents(path, contents, -1, &error)) {
+        g_warning("Probe: failed to save %s: %s", path, error->message);
+        g_error_free(error);
+    }
+    g_free(dir);
+    g_free(path);
+    g_free(contents);
+}
+
+static void queue_stats_write(void) {
+    if (!probe_save_pool)
+        probe_save_pool = g_thread_pool_new(write_stats, NULL, 1, FALSE, NULL);
+    g_thread_pool_push(probe_save_pool, g_key_file_to_data(probe_stats, NULL, NULL), NULL);
+}
+
+static gboolean on_stats_save_timeout(gpointer data) {
+    probe_save_source = 0;
+    queue_stats_write();
+    return G_SOURCE_REMOVE;
+}
+
+static void save_stats(void) {
+    if (!probe_save_source)
+        probe_save_source = g_timeout_add_seconds(STATS_SAVE_DELAY_SECONDS, on_stats_save_timeout, NULL);
+}
+
+static void record_latency(LauncherPlugin *launcher, const gchar *app_id, gint64 usec) {
+    GKeyFile *stats = get_stats();
+    gint histogram[N_BUCKETS] = { 0 };
+    gint *stored;
+    gsize length = 0;
+    guint i, bucket;
+    gint ms = usec / 1000;
+
+    stored = g_key_file_get_integer_list(stats, app_id, STATS_GROUP_HISTOGRAM, &length, NULL);
+    for (i = 0; stored && i < MIN(length, N_BUCKETS); i++)
+        histogram[i] = stored[i];
+    g_free(stored);
+
+    for (bucket = 0; bucket < G_N_ELEMENTS(bucket_limits) && ms >= bucket_limits[bucket]; bucket++)
+        ;
+    histogram[bucket]++;
+
+    g_key_file_set_integer_list(stats, app_id, STATS_GROUP_HISTOGRAM, histogram, N_BUCKETS);
+    g_key_file_set_int64(stats, app_id, STATS_KEY_TOTAL,
+                         g_key_file_get_int64(stats, app_id, STATS_KEY_TOTAL, NULL) + ms);
+    save_stats();
+
+    g_debug("Probe: %s mapped its first window %.1f ms after the click", app_id, usec / 1000.0);
+}
+
+static void drop_expired(LauncherPlugin *launcher) {
+    GKeyFile *stats;
+    gint64 now = g_get_monotonic_time();
+    GList *iter = launcher->probe_pending->head;
+    gboolean changed = FALSE;
+
+    while (iter) {
+        GList *next = iter->next;
+        ProbeLaunch *launch = iter->data;
+
+        if (now - launch->start > PROBE_TIMEOUT_US) {
+            g_debug("Probe: no window from %s", launch->app_id);
+            stats = get_stats();
+            g_key_file_set_integer(stats, launch->app_id, STATS_KEY_TIMEOUTS,
+                                   g_key_file_get_integer(stats, launch->app_id, STATS_KEY_TIMEOUTS, NULL) + 1);
+            probe_launch_free(launch);
+            g_queue_delete_link(launcher->probe_pending, iter);
+            changed = TRUE;
+        }
+        iter = next;
+    }
+
+    if (changed)
+        save_stats();
+}
+
+static gchar* get_window_string(Display *xdisplay, Window xwindow, Atom property) {
+    Atom type;
+    gint format;
+    gulong n_items, remaining;
+    guchar *data = NULL;
+    gchar *value = NULL;
+
+    if (XGetWindowProperty(xdisplay, xwindow, property, 0, 1024, False, AnyPropertyType,
+                           &type, &format, &n_items, &remaining, &data) == Success && data) {
+        if (format == 8 && n_items > 0)
+            value = g_strndup((const gchar *)data, n_items);
+        XFree(data);
+    }
+    return value;
+}
+
+static GPid get_window_pid(Display *xdisplay, Window xwindow, Atom property) {
+    Atom type;
+    gint format;
+    gulong n_items, remaining;
+    guchar *data = NULL;
+    GPid pid = 0;
+
+    if (XGetWindowProperty(xdisplay, xwindow, property, 0, 1, False, XA_CARDINAL,
+                           &type, &format, &n_items, &remaining, &data) == Success && data) {
+        if (format == 32 && n_items == 1)
+            pid = (GPid)*(gulong *)data;
+        XFree(data);
+    }
+    return pid;
+}
+
+/* Match a newly seen window against the launches waiting for one */
+static void check_window(LauncherPlugin *launcher, GdkDisplay *display, Window xwindow) {
+    Display *xdisplay = GDK_DISPLAY_XDISPLAY(display);
+    gchar *startup_id;
+    GPid pid;
+    GList *iter;
+
+    gdk_x11_display_error_trap_push(display);
+    startup_id = get_window_string(xdisplay, xwindow,
+                                   gdk_x11_get_xatom_by_name_for_display(display, "_NET_STARTUP_ID"));
+    pid = get_window_pid(xdisplay, xwindow,
+                         gdk_x11_get_xatom_by_name_for_display(display, "_NET_WM_PID"));
+    gdk_x11_display_error_trap_pop_ignored(display);
+
+    for (iter = launcher->probe_pending->head; iter != NULL; iter = iter->next) {
+        ProbeLaunch *launch = iter->data;
+
+        if ((startup_id && launch->startup_id && strcmp(startup_id, launch->startup_id) == 0) ||
+            (pid != 0 && pid == launch->pid)) {
+            record_latency(launcher, launch->app_id, g_get_monotonic_time() - launch->start);
+            probe_launch_free(launch);
+            g_queue_delete_link(launcher->probe_pending, iter);
+            break;
+        }
+    }
+    g_free(startup_id);
+}
+
+/* Check the windows added to _NET_CLIENT_LIST since the last change */
+static void check_client_list(LauncherPlugin *launcher, GdkDisplay *display, Window root) {
+    Display *xdisplay = GDK_DISPLAY_XDISPLAY(display);
+    GHashTable *clients = g_hash_table_new(g_direct_hash, g_direct_equal);
+    Atom type;
+    gint format;
+    gulong n_items = 0, remaining, i;
+    guchar *data = NULL;
+
+    gdk_x11_display_error_trap_push(display);
+    if (XGetWindowProperty(xdisplay, root, gdk_x11_get_xatom_by_name_for_display(display, "_NET_CLIENT_LIST"),
+                           0, G_MAXLONG, False, XA_WINDOW, &type, &format, &n_items, &remaining,
+                           &data) != Success)
+        data = NULL;
+    gdk_x11_display_error_trap_pop_ignored(display);
+
+    for (i = 0; data && format == 32 && i < n_items; i++) {
+        Window xwindow = ((gulong *)data)[i];
+
+        g_hash_table_add(clients, GSIZE_TO_POINTER(xwindow));
+        if (launcher->probe_clients && !g_queue_is_empty(launcher->probe_pending) &&
+            !g_hash_table_contains(launcher->probe_clients, GSIZE_TO_POINTER(xwindow)))
+            check_window(launcher, display, xwindow);
+    }
+    if (data)
+        XFree(data);
+
+    if (launcher->probe_clients)
+        g_hash_table_destroy(launcher->probe_clients);
+    launcher->probe_clients = clients;
+}
+
+static GdkFilterReturn on_root_event(GdkXEvent *gdk_xevent, GdkEvent *event, gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+    XEvent *xevent = (XEvent *)gdk_xevent;
+    GdkDisplay *display = gdk_display_get_default();
+
+    /* The client list is tracked even when idle, so only new windows are checked later */
+    if (xevent->type == MapNotify && !xevent->xmap.override_redirect) {
+        if (!g_queue_is_empty(launcher->probe_pending))
+            check_window(launcher, display, xevent->xmap.window);
+    } else if (xevent->type == PropertyNotify &&
+               xevent->xproperty.atom == gdk_x11_get_xatom_by_name_for_display(display, "_NET_CLIENT_LIST")) {
+        check_client_list(launcher, display, xevent->xproperty.window);
+    }
+
+    return GDK_FILTER_CONTINUE;
+}
+
+static gboolean on_probe_sweep(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+
+    drop_expired(launcher);
+    if (!g_queue_is_empty(launcher->probe_pending))
+        return G_SOURCE_CONTINUE;
+
+    launcher->probe_sweep_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+/* Watch the root window, only while the probe is enabled */
+static void watch_root(LauncherPlugin *launcher) {
+    GdkDisplay *display = gdk_display_get_default();
+    GdkWindow *root;
+
+    if (launcher->probe_pending || !GDK_IS_X11_DISPLAY(display))
+        return;
+
+    launcher->probe_pending = g_queue_new();
+    root = gdk_get_default_root_window();
+    gdk_window_set_events(root, gdk_window_get_events(root) |
+                                GDK_SUBSTRUCTURE_MASK | GDK_PROPERTY_CHANGE_MASK);
+    gdk_window_add_filter(root, on_root_event, launcher);
+
+    /* Windows already managed are never a match */
+    check_client_list(launcher, display, GDK_WINDOW_XID(root));
+}
+
+/* The XFCE_LAUNCHER_PROBE environment variable enables it for automated runs */
+void probe_init(LauncherPlugin *launcher) {
+    probe_users++;
+    if (g_getenv("XFCE_LAUNCHER_PROBE"))
+        launcher->launch_probe = TRUE;
+    if (launcher->launch_probe)
+        watch_root(launcher);
+}
+
+void probe_set_enabled(LauncherPlugin *launcher, gboolean enabled) {
+    launcher->launch_probe = enabled;
+    if (enabled)
+        watch_root(launcher);
+}
+
+/* Start waiting for the window of a launch, the pid or the startup id may be unknown */
+void probe_launch_started(LauncherPlugin *launcher, const gchar *app_id, const gchar *startup_id,
+                          GPid pid, gint64 start) {
+    ProbeLaunch *launch;
+
+    if (!launcher->launch_probe || !launcher->probe_pending || !app_id)
+        return;
+
+    launch = g_new0(ProbeLaunch, 1);
+    launch->app_id = g_strdup(app_id);
+    launch->startup_id = g_strdup(startup_id);
+    launch->pid = pid;
+    launch->start = start;
+    g_queue_push_tail(launcher->probe_pending, launch);
+
+    if (!launcher->probe_sweep_source)
+        launcher->probe_sweep_source = g_timeout_add_seconds(PROBE_SWEEP_SECONDS, on_probe_sweep, launcher);
+}
+
+void probe_free(LauncherPlugin *launcher) {
+    if (launcher->probe_sweep_source) {
+        g_source_remove(launcher->probe_sweep_source);
+        launcher->probe_sweep_source = 0;
+    }
+    if (launcher->probe_pending) {
+        gdk_window_remove_filter(gdk_get_default_root_window(), on_root_event, launcher);
+        g_queue_free_full(launcher->probe_pending, (GDestroyNotify)probe_launch_free);
+        launcher->probe_pending = NULL;
+    }
+    g_clear_pointer(&launcher->probe_clients, g_hash_table_destroy);
+
+    /* The last launcher saves what is pending and waits for the writer */
+    if (probe_users == 0 || --probe_users > 0)
+        return;
+
+    if (probe_save_source) {
+        g_source_remove(probe_save_source);
+        probe_save_source = 0;
+        queue_stats_write();
+    }
+    if (probe_save_pool) {
+        g_thread_pool_free(probe_save_pool, FALSE, TRUE);
+        probe_save_pool = NULL;
+    }
+    g_clear_pointer(&probe_stats, g_key_file_free);
+}
+
+/* Bucket holding the median, as an upper bound in ms; -1 for the open ended bucket */
+static gint get_median_limit(const gint *histogram, gint count) {
+    gint seen = 0;
+    guint i;
+
+    for (i = 0; i < N_BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen * 2 >= count)
+            return i < G_N_ELEMENTS(bucket_limits) ? bucket_limits[i] : -1;
+    }
+    return -1;
+}
+
+static gchar* get_app_name(const gchar *app_id) {
+    GDesktopAppInfo *info = g_desktop_app_info_new(app_id);
+    gchar *name;
+
+    if (!info)
+        return g_strdup(app_id);
+    name = g_strdup(g_app_info_get_display_name(G_APP_INFO(info)));
+    g_object_unref(info);
+    return name;
+}
+
+enum {
+    COLUMN_NAME,
+    COLUMN_LAUNCHES,
+    COLUMN_MEDIAN,
+    COLUMN_MEAN,
+    COLUMN_TIMEOUTS,
+    COLUMN_HISTOGRAM,
+    N_COLUMNS
+};
+
+static GtkListStore* create_stats_store(LauncherPlugin *launcher) {
+    GKeyFile *stats = get_stats();
+    GtkListStore *store = gtk_list_store_new(N_COLUMNS, G_TYPE_STRING, G_TYPE_INT, G_TYPE_STRING,
+                                             G_TYPE_STRING, G_TYPE_INT, G_TYPE_STRING);
+    gchar **groups = g_key_file_get_groups(stats, NULL);
+    guint i, j;
+
+    for (i = 0; groups && groups[i]; i++) {
+        gint histogram[N_BUCKETS] = { 0 };
+        gint *stored;
+        gsize length = 0;
+        gint count = 0, median;
+        GString *bars = g_string_new(NULL);
+        gchar *name, *median_text, *mean_text;
+        GtkTreeIter iter;
+
+        stored = g_key_file_get_integer_list(stats, groups[i], STATS_GROUP_HISTOGRAM, &length, NULL);
+        for (j = 0; stored && j < MIN(length, N_BUCKETS); j++) {
+            histogram[j] = stored[j];
+            count += stored[j];
+        }
+        g_free(stored);
+
+        for (j = 0; j < N_BUCKETS; j++)
+            g_string_append_printf(bars, j ? " | %d" : "%d", histogram[j]);
+
+        median = get_median_limit(histogram, count);
+        if (count == 0)
+            median_text = g_strdup("-");
+        else if (median < 0)
+            median_text = g_strdup_printf("> %d ms", bucket_limits[G_N_ELEMENTS(bucket_limits) - 1]);
+        else
+            median_text = g_strdup_printf("< %d ms", median);
+        mean_text = count ? g_strdup_printf("%" G_GINT64_FORMAT " ms",
+                                            g_key_file_get_int64(stats, groups[i], STATS_KEY_TOTAL, NULL) / count)
+                          : g_strdup("-");
+        name = get_app_name(groups[i]);
+
+        gtk_list_store_append(store, &iter);
+        gtk_list_store_set(store, &iter,
+                           COLUMN_NAME, name,
+                           COLUMN_LAUNCHES, count,
+                           COLUMN_MEDIAN, median_text,
+                           COLUMN_MEAN, mean_text,
+                           COLUMN_TIMEOUTS, g_key_file_get_integer(stats, groups[i], STATS_KEY_TIMEOUTS, NULL),
+                           COLUMN_HISTOGRAM, bars->str,
+                           -1);
+
+        g_free(name);
+        g_free(median_text);
+        g_free(mean_text);
+        g_string_free(bars, TRUE);
+    }
+    g_strfreev(groups);
+
+    return store;
+}
+
+static void add_text_column(GtkWidget *view, const gchar *title, gint column) {
+    GtkTreeViewColumn *tree_column;
+
+    tree_column = gtk_tree_view_column_new_with_attributes(title, gtk_cell_renderer_text_new(),
+                                                           "text", column, NULL);
+    gtk_tree_view_column_set_sort_column_id(tree_column, column);
+    gtk_tree_view_column_set_resizable(tree_column, TRUE);
+    gtk_tree_view_append_column(GTK_TREE_VIEW(view), tree_column);
+}
+
+/* Diagnostics view of the recorded latencies */
+void probe_show_diagnostics(LauncherPlugin *launcher, GtkWindow *parent) {
+    GtkWidget *dialog, *content_area, *vbox, *label, *scrolled, *view;
+    GtkListStore *store;
+    GString *legend = g_string_new("Launches per bucket:");
+    guint i;
+
+    dialog = gtk_dialog_new_with_buttons("Launch Latency", parent,
+                                        GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
+                                        "_Close", GTK_RESPONSE_CLOSE,
+                                        NULL);
+    gtk_window_set_default_size(GTK_WINDOW(dialog), 700, 400);
+
+    content_area = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
+    vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 6);
+    gtk_container_set_border_width(GTK_CONTAINER(vbox), 12);
+    gtk_container_add(GTK_CONTAINER(content_area), vbox);
+
+    label = gtk_label_new(launcher->launch_probe ?
+                          "Time from the click to the application's first window." :
+                          "The probe is off, enable it to record new launches.");
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0);
+    gtk_box_pack_start(GTK_BOX(vbox), label, FALSE, FALSE, 0);
+
+    for (i = 0; i < G_N_ELEMENTS(bucket_limits); i++)
+        g_string_append_printf(legend, " < %d ms |", bucket_limits[i]);
+    g_string_append(legend, " slower");
+    label = gtk_label_new(legend->str);
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0);
+    gtk_box_pack_start(GTK_BOX(vbox), label, FALSE, FALSE, 0);
+    g_string_free(legend, TRUE);
+
+    store = create_stats_store(launcher);
+    gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(store), COLUMN_LAUNCHES, GTK_SORT_DESCENDING);
+    view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(store));
+    g_object_unref(store);
+
+    add_text_column(view, "Application", COLUMN_NAME);
+    add_text_column(view, "Launches", COLUMN_LAUNCHES);
+    add_text_column(view, "Median", COLUMN_MEDIAN);
+    add_text_column(view, "Mean", COLUMN_MEAN);
+    add_text_column(view, "No window", COLUMN_TIMEOUTS);
+    add_text_column(view, "Histogram", COLUMN_HISTOGRAM);
+
+    scrolled = gtk_scrolled_window_new(NULL, NULL);
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_container_add(GTK_CONTAINER(scrolled), view);
+    gtk_box_pack_start(GTK_BOX(vbox), scrolled, TRUE, TRUE, 0);
+
+    gtk_widget_show_all(dialog);
+    gtk_dialog_run(GTK_DIALOG(dialog));
+    gtk_widget_destroy(dialog);
+}
@@ -0,0 +1,68 @@
+/*
+ * Scroll input accumulator for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <math.h>
+
+/* Travel a gesture needs before the page changes, one wheel notch */
+#define SCROLL_ENGAGE_DELTA 1.0
+/* Travel below which an axis is not locked yet, filters diagonal jitter */
+#define SCROLL_AXIS_DELTA 0.1
+/* Pause that ends a gesture when the device sends no stop event */
+#define SCROLL_GESTURE_GAP_US 200000
+
+void scroll_accumulator_reset(ScrollAccumulator *acc) {
+    acc->dx = 0.0;
+    acc->dy = 0.0;
+    acc->axis = SCROLL_AXIS_NONE;
+    acc->engaged = FALSE;
+}
+
+/*
+ * Integrate one smooth scroll event and return the page step to commit.
+ * Once a gesture engaged it stays engaged until the fingers stop or the
+ * stream pauses, so one flick moves exactly one page however many events
+ * it produces.
+ */
+gint scroll_accumulator_feed(ScrollAccumulator *acc, gdouble delta_x, gdouble delta_y,
+                             gint64 time, gboolean is_stop) {
+    gdouble travel;
+    gint step = 0;
+
+    if (acc->last_time != 0 && time - acc->last_time > SCROLL_GESTURE_GAP_US)
+        scroll_accumulator_reset(acc);
+    acc->last_time = time;
+
+    acc->dx += delta_x;
+    acc->dy += delta_y;
+
+    /* Lock to the dominant axis once the gesture has a direction */
+    if (acc->axis == SCROLL_AXIS_NONE && MAX(fabs(acc->dx), fabs(acc->dy)) >= SCROLL_AXIS_DELTA)
+        acc->axis = fabs(acc->dx) > fabs(acc->dy) ? SCROLL_AXIS_X : SCROLL_AXIS_Y;
+
+    travel = acc->axis == SCROLL_AXIS_X ? acc->dx : acc->axis == SCROLL_AXIS_Y ? acc->dy : 0.0;
+
+    if (!acc->engaged && fabs(travel) >= SCROLL_ENGAGE_DELTA) {
+        step = travel > 0 ? 1 : -1;
+        acc->engaged = TRUE;
+    }
+
+    if (is_stop)
+        scroll_accumulator_reset(acc);
+
+    return step;
+}
+
+/* At most one page change per frame, e.g. a fast spinning wheel */
+gboolean scroll_accumulator_claim_frame(ScrollAccumulator *acc, gint64 frame) {
+    if (frame == acc->commit_frame)
+        return FALSE;
+
+    acc->commit_frame = frame;
+    return TRUE;
+}
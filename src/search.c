@@ -0,0 +1,252 @@
+/*
+ * Application search for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <string.h>
+
+/*
+ * Three ways to find the applications matching the search text, picked in
+ * the settings. Linear lowercases every name on each keystroke. Trigram
+ * keeps the lowercased names and an index of their byte trigrams, so a
+ * query only checks the names sharing its rarest trigram. Fuzzy matches
+ * the letters in order with gaps and ranks the tighter matches first.
+ */
+
+/* Per launcher index, rebuilt on the first search after the app list changed */
+typedef struct {
+    GPtrArray  *apps;
+    GPtrArray  *names;
+    GHashTable *trigrams;
+} SearchIndex;
+
+static void search_index_free(SearchIndex *index) {
+    g_ptr_array_unref(index->apps);
+    g_ptr_array_unref(index->names);
+    if (index->trigrams)
+        g_hash_table_destroy(index->trigrams);
+    g_free(index);
+}
+
+static guint32 pack_trigram(const gchar *text) {
+    return (guint8)text[0] << 16 | (guint8)text[1] << 8 | (guint8)text[2];
+}
+
+static SearchIndex* get_index(LauncherPlugin *launcher, gboolean trigrams) {
+    SearchIndex *index = launcher->search_index;
+    gint64 start;
+    GList *iter;
+    guint i;
+
+    if (index && (!trigrams || index->trigrams))
+        return index;
+
+    start = g_get_monotonic_time();
+    if (!index) {
+        index = g_new0(SearchIndex, 1);
+        index->apps = g_ptr_array_new();
+        index->names = g_ptr_array_new_with_free_func(g_free);
+        for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+            AppInfo *app_info = (AppInfo *)iter->data;
+
+            if (!app_info->name)
+                continue;
+            g_ptr_array_add(index->apps, app_info);
+            g_ptr_array_add(index->names, g_utf8_strdown(app_info->name, -1));
+        }
+        launcher->search_index = index;
+    }
+
+    /* Posting lists hold app indices in ascending order, each at most once */
+    if (trigrams) {
+        index->trigrams = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
+                                                (GDestroyNotify)g_array_unref);
+        for (i = 0; i < index->names->len; i++) {
+            const gchar *name = g_ptr_array_index(index->names, i);
+            gsize length = strlen(name), j;
+
+            for (j = 0; j + 3 <= length; j++) {
+                gpointer key = GUINT_TO_POINTER(pack_trigram(name + j));
+                GArray *postings = g_hash_table_lookup(index->trigrams, key);
+
+                if (!postings) {
+                    postings = g_array_new(FALSE, FALSE, sizeof(guint));
+                    g_hash_table_insert(index->trigrams, key, postings);
+                }
+                if (postings->len == 0 || g_array_index(postings, guint, postings->len - 1) != i)
+                    g_array_append_val(postings, i);
+            }
+        }
+    }
+
+    g_debug("Search: indexed %u applications%s in %.2f ms", index->apps->len,
+            trigrams ? " with trigrams" : "", (g_get_monotonic_time() - start) / 1000.0);
+    return index;
+}
+
+/* The app list, its order or names changed */
+void search_invalidate(LauncherPlugin *launcher) {
+    g_clear_pointer(&launcher->search_index, search_index_free);
+}
+
+void search_free(LauncherPlugin *launcher) {
+    search_invalidate(launcher);
+}
+
+static GList* search_linear(LauncherPlugin *launcher, const gchar *query) {
+    GList *results = NULL;
+    GList *iter;
+
+    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app_info = (AppInfo *)iter->data;
+        if (app_info && app_info->name && !app_info->is_hidden) {
+            gchar *name_lower = g_utf8_strdown(app_info->name, -1);
+            if (strstr(name_lower, query) != NULL)
+                results = g_list_prepend(results, app_info);
+            g_free(name_lower);
+        }
+    }
+
+    return g_list_reverse(results);
+}
+
+static GList* search_trigram(LauncherPlugin *launcher, const gchar *query) {
+    SearchIndex *index = get_index(launcher, TRUE);
+    gsize length = strlen(query), i;
+    GArray *shortest = NULL;
+    GList *results = NULL;
+
+    /* Too short for a trigram, the lowercased names still spare the work per keystroke */
+    if (length < 3) {
+        for (i = index->apps->len; i-- > 0;) {
+            AppInfo *app_info = g_ptr_array_index(index->apps, i);
+            if (!app_info->is_hidden && strstr(g_ptr_array_index(index->names, i), query))
+                results = g_list_prepend(results, app_info);
+        }
+        return results;
+    }
+
+    for (i = 0; i + 3 <= length; i++) {
+        GArray *postings = g_hash_table_lookup(index->trigrams, GUINT_TO_POINTER(pack_trigram(query + i)));
+
+        /* No name has this trigram, so none contains the query */
+        if (!postings)
+            return NULL;
+        if (!shortest || postings->len < shortest->len)
+            shortest = postings;
+    }
+
+    for (i = shortest->len; i-- > 0;) {
+        guint app = g_array_index(shortest, guint, i);
+        AppInfo *app_info = g_ptr_array_index(index->apps, app);
+
+        if (!app_info->is_hidden && strstr(g_ptr_array_index(index->names, app), query))
+            results = g_list_prepend(results, app_info);
+    }
+
+    return results;
+}
+
+/*
+ * Score the letters of query found in order in name, 0 if they are not.
+ * Runs of consecutive letters and letters starting a word score higher,
+ * so "fx" ranks "Firefox" below "FX Mixer".
+ */
+static gint fuzzy_score(const gchar *name, const gchar *query) {
+    const gchar *n = name, *q = query;
+    gint score = 0, run = 0;
+    gboolean word_start = TRUE;
+
+    while (*n && *q) {
+        gunichar nc = g_utf8_get_char(n);
+
+        if (nc == g_utf8_get_char(q)) {
+            run++;
+            score += 1 + run * 2 + (word_start ? 8 : 0);
+            q = g_utf8_next_char(q);
+        } else {
+            run = 0;
+        }
+        word_start = !g_unichar_isalnum(nc);
+        n = g_utf8_next_char(n);
+    }
+
+    if (*q)
+        return 0;
+
+    /* Shorter names win among equal matches */
+    return score * 256 / (256 + (gint)(n - name) + (gint)strlen(n));
+}
+
+typedef struct {
+    AppInfo *app_info;
+    gint    score;
+    gdouble usage;
+} FuzzyMatch;
+
+/* Frecency breaks ties, then the grid order the sort keeps */
+static gint compare_fuzzy_matches(gconstpointer a, gconstpointer b) {
+    const FuzzyMatch *match_a = (const FuzzyMatch *)a;
+    const FuzzyMatch *match_b = (const FuzzyMatch *)b;
+
+    if (match_a->score != match_b->score)
+        return match_b->score - match_a->score;
+    if (match_a->usage != match_b->usage)
+        return match_a->usage < match_b->usage ? 1 : -1;
+    return 0;
+}
+
+static GList* search_fuzzy(LauncherPlugin *launcher, const gchar *query) {
+    SearchIndex *index = get_index(launcher, FALSE);
+    GArray *matches = g_array_new(FALSE, FALSE, sizeof(FuzzyMatch));
+    GList *results = NULL;
+    guint i;
+
+    for (i = 0; i < index->apps->len; i++) {
+        FuzzyMatch match;
+
+        match.app_info = g_ptr_array_index(index->apps, i);
+        if (match.app_info->is_hidden)
+            continue;
+        match.score = fuzzy_score(g_ptr_array_index(index->names, i), query);
+        if (match.score > 0) {
+            match.usage = usage_get_score(launcher, match.app_info);
+            g_array_append_val(matches, match);
+        }
+    }
+
+    g_array_sort(matches, compare_fuzzy_matches);
+    for (i = matches->len; i-- > 0;)
+        results = g_list_prepend(results, g_array_index(matches, FuzzyMatch, i).app_info);
+    g_array_free(matches, TRUE);
+
+    return results;
+}
+
+/* The visible applications matching text, best first */
+GList* search_applications(LauncherPlugin *launcher, const gchar *text) {
+    gchar *query = g_utf8_strdown(text, -1);
+    gint64 start = g_get_monotonic_time();
+    GList *results;
+
+    switch (launcher->search_backend) {
+        case SEARCH_BACKEND_TRIGRAM:
+            results = usage_rank(launcher, search_trigram(launcher, query));
+            break;
+        case SEARCH_BACKEND_FUZZY:
+            results = search_fuzzy(launcher, query);
+            break;
+        default:
+            results = usage_rank(launcher, search_linear(launcher, query));
+            break;
+    }
+
+    perf_counter_add(&launcher->search_time, g_get_monotonic_time() - start);
+    g_free(query);
+
+    return results;
+}
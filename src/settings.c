@@ -15,11 +15,23 @@
 
 #include "settings.h"
 
+static void on_property_changed(XfconfChannel *channel, const gchar *property,
+                                const GValue *value, LauncherPlugin *launcher);
+static void apply_icon_cache_mb(LauncherPlugin *launcher, guint icon_cache_mb);
+static void apply_monitor_debounce(LauncherPlugin *launcher, guint debounce_ms);
+
 /* Initialize settings management */
 void launcher_settings_init(LauncherPlugin *launcher) {
     gchar *property_base;
     const gchar *icon_name;
     
+    /* Performance defaults stand if Xfconf is unavailable */
+    launcher->prerender_depth = DEFAULT_PRERENDER_DEPTH;
+    launcher->search_backend = DEFAULT_SEARCH_BACKEND;
+    launcher->worker_threads = DEFAULT_WORKER_THREADS;
+    apply_icon_cache_mb(launcher, DEFAULT_ICON_CACHE_MB);
+    apply_monitor_debounce(launcher, DEFAULT_MONITOR_DEBOUNCE);
+    
     /* Initialize Xfconf if not already done */
     if (!xfconf_init(NULL)) {
         g_warning("Failed to initialize Xfconf");
@@ -46,11 +58,44 @@ void launcher_settings_init(LauncherPlugin *launcher) {
         /* It's an icon name */
         gtk_image_set_from_icon_name(GTK_IMAGE(launcher->icon), icon_name, GTK_ICON_SIZE_BUTTON);
     }
+    
+    /* Load grid drawing mode */
+    launcher->drawn_grid = xfconf_channel_get_bool(launcher->channel, SETTING_DRAWN_GRID, DEFAULT_DRAWN_GRID);
+    launcher->hot_standby = xfconf_channel_get_bool(launcher->channel, SETTING_HOT_STANDBY, DEFAULT_HOT_STANDBY);
+    launcher->page_transition = CLAMP(xfconf_channel_get_uint(launcher->channel, SETTING_PAGE_TRANSITION,
+                                                              DEFAULT_PAGE_TRANSITION),
+                                      PAGE_TRANSITION_NONE, PAGE_TRANSITION_FADE);
+    launcher->launch_probe = xfconf_channel_get_bool(launcher->channel, SETTING_LAUNCH_PROBE, DEFAULT_LAUNCH_PROBE);
+    launcher->prefetch = xfconf_channel_get_bool(launcher->channel, SETTING_PREFETCH, DEFAULT_PREFETCH);
+    launcher->frequent_page = xfconf_channel_get_bool(launcher->channel, SETTING_FREQUENT_PAGE,
+                                                      DEFAULT_FREQUENT_PAGE);
+    
+    /* Performance settings, changes made anywhere apply through on_property_changed */
+    apply_icon_cache_mb(launcher, xfconf_channel_get_uint(launcher->channel, SETTING_ICON_CACHE_MB,
+                                                          DEFAULT_ICON_CACHE_MB));
+    launcher->prerender_depth = MIN(xfconf_channel_get_uint(launcher->channel, SETTING_PRERENDER_DEPTH,
+                                                            DEFAULT_PRERENDER_DEPTH),
+                                    MAX_PRERENDER_DEPTH);
+    apply_monitor_debounce(launcher, xfconf_channel_get_uint(launcher->channel, SETTING_MONITOR_DEBOUNCE,
+                                                             DEFAULT_MONITOR_DEBOUNCE));
+    launcher->search_backend = CLAMP(xfconf_channel_get_uint(launcher->channel, SETTING_SEARCH_BACKEND,
+                                                             DEFAULT_SEARCH_BACKEND),
+                                     SEARCH_BACKEND_LINEAR, SEARCH_BACKEND_FUZZY);
+    launcher->worker_threads = CLAMP(xfconf_channel_get_uint(launcher->channel, SETTING_WORKER_THREADS,
+                                                             DEFAULT_WORKER_THREADS),
+                                     1, MAX_WORKER_THREADS);
+    perf_set_tracing(launcher, xfconf_channel_get_bool(launcher->channel, SETTING_TRACING, DEFAULT_TRACING));
+    
+    g_signal_connect(launcher->channel, "property-changed",
+                     G_CALLBACK(on_property_changed), launcher);
 }
 
 /* Free settings resources */
 void launcher_settings_free(LauncherPlugin *launcher) {
+    perf_set_tracing(launcher, FALSE);
+
     if (launcher->channel) {
+        g_signal_handlers_disconnect_by_data(launcher->channel, launcher);
         g_object_unref(launcher->channel);
         launcher->channel = NULL;
     }
@@ -89,77 +134,193 @@ void launcher_settings_set_icon_name(LauncherPlugin *launcher, const gchar *icon
     gtk_image_set_pixel_size(GTK_IMAGE(launcher->icon), size - 4);
 }
 
-/* Helper to create icon list store with larger icons */
-static GtkListStore* create_icon_store(void) {
-    GtkListStore *store;
-    GtkTreeIter iter;
-    GtkIconTheme *icon_theme;
-    const gchar *common_icons[] = {
-        "application-x-executable",
-        "applications-other",
-        "applications-system",
-        "applications-utilities",
-        "preferences-system",
-        "system-run",
-        "view-grid-symbolic",
-        "view-app-grid-symbolic",
-        "application-menu",
-        "show-apps",
-        "xfce-launcher",
-        "xfce4-whiskermenu",
-        "start-here",
-        "distributor-logo",
-        "applications-all",
-        "applications-accessories",
-        "applications-development",
-        "applications-games",
-        "applications-graphics",
-        "applications-internet",
-        "applications-multimedia",
-        "applications-office",
-        "applications-science",
-        "folder-applications",
-        NULL
-    };
-    int i;
-    
-    store = gtk_list_store_new(2, G_TYPE_STRING, GDK_TYPE_PIXBUF);
-    icon_theme = gtk_icon_theme_get_default();
-    
-    for (i = 0; common_icons[i] != NULL; i++) {
-        GdkPixbuf *pixbuf = gtk_icon_theme_load_icon(icon_theme, common_icons[i], 48, 0, NULL);
-        if (pixbuf) {
-            gtk_list_store_append(store, &iter);
-            gtk_list_store_set(store, &iter,
-                             0, common_icons[i],
-                             1, pixbuf,
-                             -1);
-            g_object_unref(pixbuf);
-        }
+/* Switch between the widget grid and the custom drawn grid */
+void launcher_settings_set_drawn_grid(LauncherPlugin *launcher, gboolean drawn_grid) {
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_DRAWN_GRID, drawn_grid);
+    
+    if (launcher->drawn_grid == drawn_grid)
+        return;
+    
+    launcher->drawn_grid = drawn_grid;
+    
+    /* Recreate the grid in place, the overlay itself is kept */
+    if (launcher->overlay_window) {
+        create_app_grid(launcher);
+        populate_current_page(launcher);
     }
+}
+
+/* Keep the overlay realized and its first page built while hidden */
+void launcher_settings_set_hot_standby(LauncherPlugin *launcher, gboolean hot_standby) {
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_HOT_STANDBY, hot_standby);
     
-    return store;
+    launcher->hot_standby = hot_standby;
+    
+    if (hot_standby && launcher->overlay_window) {
+        gtk_widget_realize(launcher->overlay_window);
+        schedule_standby_rebuild(launcher);
+    }
 }
 
-/* Icon selection changed */
-static void on_icon_selection_changed(GtkIconView *icon_view, LauncherPlugin *launcher) {
-    GtkTreeModel *model;
-    GtkTreeIter iter;
-    GList *selected;
-    gchar *icon_name;
+/* Animation used by the drawn grid when flipping pages */
+void launcher_settings_set_page_transition(LauncherPlugin *launcher, PageTransition transition) {
+    if (launcher->channel)
+        xfconf_channel_set_uint(launcher->channel, SETTING_PAGE_TRANSITION, transition);
     
-    selected = gtk_icon_view_get_selected_items(icon_view);
-    if (selected) {
-        model = gtk_icon_view_get_model(icon_view);
-        if (gtk_tree_model_get_iter(model, &iter, selected->data)) {
-            gtk_tree_model_get(model, &iter, 0, &icon_name, -1);
-            launcher_settings_set_icon_name(launcher, icon_name);
-            g_free(icon_name);
-        }
-        g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+    launcher->page_transition = transition;
+}
+
+/* Record click to window latencies of launched applications */
+void launcher_settings_set_launch_probe(LauncherPlugin *launcher, gboolean launch_probe) {
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_LAUNCH_PROBE, launch_probe);
+    
+    probe_set_enabled(launcher, launch_probe);
+}
+
+/* Read ahead the binaries of frequently launched applications */
+void launcher_settings_set_prefetch(LauncherPlugin *launcher, gboolean prefetch) {
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_PREFETCH, prefetch);
+    
+    launcher->prefetch = prefetch;
+}
+
+/* Put the most used applications on a page of their own in front */
+void launcher_settings_set_frequent_page(LauncherPlugin *launcher, gboolean frequent_page) {
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_FREQUENT_PAGE, frequent_page);
+    
+    if (launcher->frequent_page == frequent_page)
+        return;
+    
+    launcher->frequent_page = frequent_page;
+    invalidate_page_index(launcher);
+    
+    if (launcher->overlay_window) {
+        launcher->current_page = 0;
+        populate_current_page(launcher);
+        update_page_dots(launcher);
+    }
+}
+
+/* Bytes of decoded icons kept, shared by every launcher of the panel */
+static void apply_icon_cache_mb(LauncherPlugin *launcher, guint icon_cache_mb) {
+    launcher->icon_cache_mb = CLAMP(icon_cache_mb, MIN_ICON_CACHE_MB, MAX_ICON_CACHE_MB);
+    catalog_set_icon_cache_limit((gsize)launcher->icon_cache_mb * 1024 * 1024);
+}
+
+/* Quiet time of the application directories before a rescan, shared like the catalog */
+static void apply_monitor_debounce(LauncherPlugin *launcher, guint debounce_ms) {
+    launcher->monitor_debounce = MIN(debounce_ms, MAX_MONITOR_DEBOUNCE);
+    catalog_set_reload_delay(launcher->monitor_debounce);
+}
+
+static void apply_search_backend(LauncherPlugin *launcher, SearchBackend backend) {
+    backend = CLAMP(backend, SEARCH_BACKEND_LINEAR, SEARCH_BACKEND_FUZZY);
+    if (launcher->search_backend == backend)
+        return;
+    
+    launcher->search_backend = backend;
+    search_invalidate(launcher);
+    
+    /* Rerun a search in progress with the new backend */
+    if (launcher->search_entry && *gtk_entry_get_text(GTK_ENTRY(launcher->search_entry)))
+        on_search_changed(GTK_SEARCH_ENTRY(launcher->search_entry), launcher);
+}
+
+void launcher_settings_set_icon_cache_mb(LauncherPlugin *launcher, guint icon_cache_mb) {
+    if (launcher->channel)
+        xfconf_channel_set_uint(launcher->channel, SETTING_ICON_CACHE_MB, icon_cache_mb);
+    
+    apply_icon_cache_mb(launcher, icon_cache_mb);
+}
+
+/* Pages whose icons the warm-up decodes, 0 turns the warm-up off */
+void launcher_settings_set_prerender_depth(LauncherPlugin *launcher, guint depth) {
+    if (launcher->channel)
+        xfconf_channel_set_uint(launcher->channel, SETTING_PRERENDER_DEPTH, depth);
+    
+    launcher->prerender_depth = MIN(depth, MAX_PRERENDER_DEPTH);
+}
+
+void launcher_settings_set_monitor_debounce(LauncherPlugin *launcher, guint debounce_ms) {
+    if (launcher->channel)
+        xfconf_channel_set_uint(launcher->channel, SETTING_MONITOR_DEBOUNCE, debounce_ms);
+    
+    apply_monitor_debounce(launcher, debounce_ms);
+}
+
+void launcher_settings_set_search_backend(LauncherPlugin *launcher, SearchBackend backend) {
+    if (launcher->channel)
+        xfconf_channel_set_uint(launcher->channel, SETTING_SEARCH_BACKEND, backend);
+    
+    apply_search_backend(launcher, backend);
+}
+
+/* Threads reading ahead frequently launched applications */
+void launcher_settings_set_worker_threads(LauncherPlugin *launcher, guint threads) {
+    if (launcher->channel)
+        xfconf_channel_set_uint(launcher->channel, SETTING_WORKER_THREADS, threads);
+    
+    usage_set_worker_threads(launcher, CLAMP(threads, 1, MAX_WORKER_THREADS));
+}
+
+/* Frame timing and the performance reports when the overlay hides */
+void launcher_settings_set_tracing(LauncherPlugin *launcher, gboolean tracing) {
+    if (launcher->channel)
+        xfconf_channel_set_bool(launcher->channel, SETTING_TRACING, tracing);
+    
+    perf_set_tracing(launcher, tracing);
+}
+
+/* Numbers set with xfconf-query may be stored as int, a reset property has no value */
+static guint get_uint_value(const GValue *value, guint default_value) {
+    if (G_VALUE_HOLDS_UINT(value))
+        return g_value_get_uint(value);
+    if (G_VALUE_HOLDS_INT(value))
+        return MAX(g_value_get_int(value), 0);
+    return default_value;
+}
+
+/* Apply performance settings changed from anywhere, the overlay is kept */
+static void on_property_changed(XfconfChannel *channel, const gchar *property,
+                                const GValue *value, LauncherPlugin *launcher) {
+    if (g_strcmp0(property, SETTING_ICON_CACHE_MB) == 0) {
+        apply_icon_cache_mb(launcher, get_uint_value(value, DEFAULT_ICON_CACHE_MB));
+    } else if (g_strcmp0(property, SETTING_PRERENDER_DEPTH) == 0) {
+        launcher->prerender_depth = MIN(get_uint_value(value, DEFAULT_PRERENDER_DEPTH), MAX_PRERENDER_DEPTH);
+    } else if (g_strcmp0(property, SETTING_MONITOR_DEBOUNCE) == 0) {
+        apply_monitor_debounce(launcher, get_uint_value(value, DEFAULT_MONITOR_DEBOUNCE));
+    } else if (g_strcmp0(property, SETTING_SEARCH_BACKEND) == 0) {
+        apply_search_backend(launcher, get_uint_value(value, DEFAULT_SEARCH_BACKEND));
+    } else if (g_strcmp0(property, SETTING_WORKER_THREADS) == 0) {
+        usage_set_worker_threads(launcher, CLAMP(get_uint_value(value, DEFAULT_WORKER_THREADS),
+                                                 1, MAX_WORKER_THREADS));
+    } else if (g_strcmp0(property, SETTING_TRACING) == 0) {
+        perf_set_tracing(launcher, G_VALUE_HOLDS_BOOLEAN(value) ? g_value_get_boolean(value) : DEFAULT_TRACING);
     }
 }
 
+/* An icon picked in the browser applies at once, a double click also closes the chooser */
+static void on_icon_picked(const gchar *icon_name, gboolean activated, gpointer data) {
+    GtkWidget *dialog = GTK_WIDGET(data);
+    LauncherPlugin *launcher = g_object_get_data(G_OBJECT(dialog), "launcher");
+    GtkWidget *entry = g_object_get_data(G_OBJECT(dialog), "entry");
+    
+    gtk_entry_set_text(GTK_ENTRY(entry), icon_name);
+    launcher_settings_set_icon_name(launcher, icon_name);
+    if (activated)
+        gtk_dialog_response(GTK_DIALOG(dialog), GTK_RESPONSE_OK);
+}
+
+/* Icon search changed */
+static void on_icon_search_changed(GtkSearchEntry *search, GtkWidget *browser) {
+    icon_browser_set_filter(browser, gtk_entry_get_text(GTK_ENTRY(search)));
+}
+
 /* Browse for custom icon from file */
 static void on_browse_clicked(GtkWidget *button, gpointer data) {
     GtkWidget *dialog;
@@ -208,16 +369,15 @@ static void on_browse_clicked(GtkWidget *button, gpointer data) {
 static void on_icon_button_clicked(GtkWidget *button, LauncherPlugin *launcher) {
     GtkWidget *dialog;
     GtkWidget *content_area;
-    GtkWidget *scrolled;
-    GtkWidget *icon_view;
-    GtkListStore *store;
+    GtkWidget *frame;
+    GtkWidget *browser;
+    GtkWidget *search;
     GtkWidget *entry;
     GtkWidget *vbox, *hbox;
     GtkWidget *label;
     GtkWidget *browse_button;
     gchar *current_icon;
-    GtkTreeIter iter;
-    gboolean valid;
+    gint64 start = g_get_monotonic_time();
     
     /* Create dialog */
     dialog = gtk_dialog_new_with_buttons("Select Icon",
@@ -236,49 +396,27 @@ static void on_icon_button_clicked(GtkWidget *button, LauncherPlugin *launcher)
     gtk_container_add(GTK_CONTAINER(content_area), vbox);
     
     /* Add label */
-    label = gtk_label_new("Select an icon from the list below:");
+    label = gtk_label_new("Select an icon from the current theme:");
     gtk_label_set_xalign(GTK_LABEL(label), 0.0);
     gtk_box_pack_start(GTK_BOX(vbox), label, FALSE, FALSE, 0);
     
-    /* Create scrolled window */
-    scrolled = gtk_scrolled_window_new(NULL, NULL);
-    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scrolled),
-                                  GTK_POLICY_AUTOMATIC,
-                                  GTK_POLICY_AUTOMATIC);
-    gtk_scrolled_window_set_min_content_height(GTK_SCROLLED_WINDOW(scrolled), 250);
-    gtk_box_pack_start(GTK_BOX(vbox), scrolled, TRUE, TRUE, 0);
-    
-    /* Create icon view with larger spacing */
-    store = create_icon_store();
-    icon_view = gtk_icon_view_new_with_model(GTK_TREE_MODEL(store));
-    gtk_icon_view_set_pixbuf_column(GTK_ICON_VIEW(icon_view), 1);
-    gtk_icon_view_set_text_column(GTK_ICON_VIEW(icon_view), 0);
-    gtk_icon_view_set_item_width(GTK_ICON_VIEW(icon_view), 120);
-    gtk_icon_view_set_column_spacing(GTK_ICON_VIEW(icon_view), 10);
-    gtk_icon_view_set_row_spacing(GTK_ICON_VIEW(icon_view), 10);
-    gtk_icon_view_set_margin(GTK_ICON_VIEW(icon_view), 10);
-    gtk_container_add(GTK_CONTAINER(scrolled), icon_view);
-    
-    /* Select current icon if it's in the list */
+    /* Search by icon name */
+    search = gtk_search_entry_new();
+    gtk_entry_set_placeholder_text(GTK_ENTRY(search), "Search icons");
+    gtk_box_pack_start(GTK_BOX(vbox), search, FALSE, FALSE, 0);
+    
+    /* Browser over the whole theme, it lists the icons once it is on screen */
+    frame = gtk_frame_new(NULL);
+    gtk_frame_set_shadow_type(GTK_FRAME(frame), GTK_SHADOW_IN);
+    gtk_widget_set_size_request(frame, -1, 250);
+    gtk_box_pack_start(GTK_BOX(vbox), frame, TRUE, TRUE, 0);
+    browser = icon_browser_new(on_icon_picked, dialog);
+    gtk_container_add(GTK_CONTAINER(frame), browser);
+    
+    /* Select current icon, unless it is a file path */
     current_icon = launcher_settings_get_icon_name(launcher);
-    if (current_icon && !g_file_test(current_icon, G_FILE_TEST_EXISTS)) {
-        /* Only try to select if it's an icon name, not a file path */
-        valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store), &iter);
-        while (valid) {
-            gchar *icon_name;
-            gtk_tree_model_get(GTK_TREE_MODEL(store), &iter, 0, &icon_name, -1);
-            if (g_strcmp0(icon_name, current_icon) == 0) {
-                GtkTreePath *path = gtk_tree_model_get_path(GTK_TREE_MODEL(store), &iter);
-                gtk_icon_view_select_path(GTK_ICON_VIEW(icon_view), path);
-                gtk_icon_view_scroll_to_path(GTK_ICON_VIEW(icon_view), path, TRUE, 0.5, 0.5);
-                gtk_tree_path_free(path);
-                g_free(icon_name);
-                break;
-            }
-            g_free(icon_name);
-            valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store), &iter);
-        }
-    }
+    if (current_icon && !g_file_test(current_icon, G_FILE_TEST_EXISTS))
+        icon_browser_select(browser, current_icon);
     
     /* Add separator */
     gtk_box_pack_start(GTK_BOX(vbox), gtk_separator_new(GTK_ORIENTATION_HORIZONTAL), FALSE, FALSE, 0);
@@ -302,33 +440,26 @@ static void on_icon_button_clicked(GtkWidget *button, LauncherPlugin *launcher)
     g_free(current_icon);
     
     /* Store references */
-    g_object_set_data(G_OBJECT(dialog), "icon-view", icon_view);
     g_object_set_data(G_OBJECT(dialog), "entry", entry);
     g_object_set_data(G_OBJECT(dialog), "launcher", launcher);
     
-    /* Connect selection signal */
-    g_signal_connect(icon_view, "selection-changed",
-                     G_CALLBACK(on_icon_selection_changed), launcher);
+    g_signal_connect(search, "search-changed",
+                     G_CALLBACK(on_icon_search_changed), browser);
     
     /* Show dialog */
     gtk_widget_show_all(dialog);
+    gtk_widget_grab_focus(search);
+    g_debug("Settings: icon chooser shown in %.2f ms", (g_get_monotonic_time() - start) / 1000.0);
     
-    /* Run dialog */
+    /* Run dialog, the entry holds the icon picked or typed */
     if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_OK) {
-        /* Use custom entry if no icon selected */
-        GList *selected = gtk_icon_view_get_selected_items(GTK_ICON_VIEW(icon_view));
-        if (!selected) {
-            const gchar *custom_icon = gtk_entry_get_text(GTK_ENTRY(entry));
-            if (custom_icon && *custom_icon) {
-                launcher_settings_set_icon_name(launcher, custom_icon);
-            }
-        } else {
-            g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+        const gchar *custom_icon = gtk_entry_get_text(GTK_ENTRY(entry));
+        if (custom_icon && *custom_icon) {
+            launcher_settings_set_icon_name(launcher, custom_icon);
         }
     }
     
     /* Cleanup */
-    g_object_unref(store);
     gtk_widget_destroy(dialog);
 }
 
@@ -342,15 +473,157 @@ static void on_reset_clicked(GtkWidget *button, gpointer data) {
     gtk_image_set_pixel_size(GTK_IMAGE(icon_image), 48);
 }
 
+/* Drawn grid toggled */
+static void on_drawn_grid_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    launcher_settings_set_drawn_grid(launcher, gtk_toggle_button_get_active(toggle));
+}
+
+/* Hot standby toggled */
+static void on_hot_standby_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    launcher_settings_set_hot_standby(launcher, gtk_toggle_button_get_active(toggle));
+}
+
+/* Page transition changed */
+static void on_page_transition_changed(GtkComboBox *combo, LauncherPlugin *launcher) {
+    launcher_settings_set_page_transition(launcher, gtk_combo_box_get_active(combo));
+}
+
+/* Launch probe toggled */
+static void on_launch_probe_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    launcher_settings_set_launch_probe(launcher, gtk_toggle_button_get_active(toggle));
+}
+
+/* Prefetch toggled */
+static void on_prefetch_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    launcher_settings_set_prefetch(launcher, gtk_toggle_button_get_active(toggle));
+}
+
+/* Frequent page toggled */
+static void on_frequent_page_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    launcher_settings_set_frequent_page(launcher, gtk_toggle_button_get_active(toggle));
+}
+
+/* Performance settings changed in the dialog */
+static void on_icon_cache_changed(GtkSpinButton *spin, LauncherPlugin *launcher) {
+    launcher_settings_set_icon_cache_mb(launcher, gtk_spin_button_get_value_as_int(spin));
+}
+
+static void on_prerender_depth_changed(GtkSpinButton *spin, LauncherPlugin *launcher) {
+    launcher_settings_set_prerender_depth(launcher, gtk_spin_button_get_value_as_int(spin));
+}
+
+static void on_monitor_debounce_changed(GtkSpinButton *spin, LauncherPlugin *launcher) {
+    launcher_settings_set_monitor_debounce(launcher, gtk_spin_button_get_value_as_int(spin));
+}
+
+static void on_search_backend_changed(GtkComboBox *combo, LauncherPlugin *launcher) {
+    launcher_settings_set_search_backend(launcher, gtk_combo_box_get_active(combo));
+}
+
+static void on_worker_threads_changed(GtkSpinButton *spin, LauncherPlugin *launcher) {
+    launcher_settings_set_worker_threads(launcher, gtk_spin_button_get_value_as_int(spin));
+}
+
+static void on_tracing_toggled(GtkToggleButton *toggle, LauncherPlugin *launcher) {
+    launcher_settings_set_tracing(launcher, gtk_toggle_button_get_active(toggle));
+}
+
+/* A labelled spin button in the next row of the performance grid */
+static GtkWidget* add_spin_row(GtkWidget *grid, gint row, const gchar *text, const gchar *tooltip,
+                               gdouble min, gdouble max, gdouble step, guint value) {
+    GtkWidget *label = gtk_label_new(text);
+    GtkWidget *spin = gtk_spin_button_new_with_range(min, max, step);
+    
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0);
+    gtk_grid_attach(GTK_GRID(grid), label, 0, row, 1, 1);
+    gtk_spin_button_set_value(GTK_SPIN_BUTTON(spin), value);
+    gtk_widget_set_tooltip_text(spin, tooltip);
+    gtk_grid_attach(GTK_GRID(grid), spin, 1, row, 1, 1);
+    
+    return spin;
+}
+
+/* The Performance tab, every change applies while the launcher runs */
+static GtkWidget* create_performance_page(LauncherPlugin *launcher) {
+    GtkWidget *grid;
+    GtkWidget *label;
+    GtkWidget *spin;
+    GtkWidget *backend_combo;
+    GtkWidget *tracing_check;
+    
+    grid = gtk_grid_new();
+    gtk_grid_set_row_spacing(GTK_GRID(grid), 6);
+    gtk_grid_set_column_spacing(GTK_GRID(grid), 12);
+    gtk_container_set_border_width(GTK_CONTAINER(grid), 12);
+    
+    spin = add_spin_row(grid, 0, "Icon cache (MiB):",
+                        "Memory for decoded icons, the oldest are dropped beyond it",
+                        MIN_ICON_CACHE_MB, MAX_ICON_CACHE_MB, 8, launcher->icon_cache_mb);
+    g_signal_connect(spin, "value-changed", G_CALLBACK(on_icon_cache_changed), launcher);
+    
+    spin = add_spin_row(grid, 1, "Pages prepared ahead:",
+                        "Pages whose icons are loaded when the pointer rests on the panel button, 0 turns this off",
+                        0, MAX_PRERENDER_DEPTH, 1, launcher->prerender_depth);
+    g_signal_connect(spin, "value-changed", G_CALLBACK(on_prerender_depth_changed), launcher);
+    
+    spin = add_spin_row(grid, 2, "Rescan delay (ms):",
+                        "Time without changes to the application folders before they are scanned again",
+                        0, MAX_MONITOR_DEBOUNCE, 50, launcher->monitor_debounce);
+    g_signal_connect(spin, "value-changed", G_CALLBACK(on_monitor_debounce_changed), launcher);
+    
+    spin = add_spin_row(grid, 3, "Preload threads:",
+                        "Threads reading frequently used applications from disk",
+                        1, MAX_WORKER_THREADS, 1, launcher->worker_threads);
+    g_signal_connect(spin, "value-changed", G_CALLBACK(on_worker_threads_changed), launcher);
+    
+    /* Search backend */
+    label = gtk_label_new("Search:");
+    gtk_label_set_xalign(GTK_LABEL(label), 0.0);
+    gtk_grid_attach(GTK_GRID(grid), label, 0, 4, 1, 1);
+    backend_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(backend_combo), "Substring");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(backend_combo), "Substring, indexed");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(backend_combo), "Fuzzy");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(backend_combo), launcher->search_backend);
+    gtk_widget_set_tooltip_text(backend_combo,
+                                "Indexed search is faster with many applications, fuzzy search also "
+                                "matches letters with gaps in between");
+    gtk_grid_attach(GTK_GRID(grid), backend_combo, 1, 4, 1, 1);
+    g_signal_connect(backend_combo, "changed", G_CALLBACK(on_search_backend_changed), launcher);
+    
+    /* Tracing */
+    tracing_check = gtk_check_button_new_with_label("Trace performance");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(tracing_check), launcher->tracing);
+    gtk_widget_set_tooltip_text(tracing_check,
+                                "Time every frame and log the measurements when the launcher hides");
+    gtk_grid_attach(GTK_GRID(grid), tracing_check, 0, 5, 2, 1);
+    g_signal_connect(tracing_check, "toggled", G_CALLBACK(on_tracing_toggled), launcher);
+    
+    return grid;
+}
+
+/* Show the recorded launch latencies */
+static void on_latency_clicked(GtkWidget *button, LauncherPlugin *launcher) {
+    probe_show_diagnostics(launcher, GTK_WINDOW(gtk_widget_get_toplevel(button)));
+}
+
 /* Show settings dialog */
 void launcher_show_settings_dialog(LauncherPlugin *launcher) {
     GtkWidget *dialog;
     GtkWidget *content_area;
+    GtkWidget *notebook;
     GtkWidget *vbox, *hbox;
     GtkWidget *label;
     GtkWidget *icon_button;
     GtkWidget *icon_image;
     GtkWidget *reset_button;
+    GtkWidget *drawn_grid_check;
+    GtkWidget *hot_standby_check;
+    GtkWidget *transition_combo;
+    GtkWidget *launch_probe_check;
+    GtkWidget *latency_button;
+    GtkWidget *prefetch_check;
+    GtkWidget *frequent_page_check;
     gchar *current_icon;
     
     /* Create dialog */
@@ -366,10 +639,16 @@ void launcher_show_settings_dialog(LauncherPlugin *launcher) {
     /* Get content area */
     content_area = gtk_dialog_get_content_area(GTK_DIALOG(dialog));
     
+    /* General and Performance tabs */
+    notebook = gtk_notebook_new();
+    gtk_container_add(GTK_CONTAINER(content_area), notebook);
+    
     /* Create main vbox */
     vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 12);
     gtk_container_set_border_width(GTK_CONTAINER(vbox), 12);
-    gtk_container_add(GTK_CONTAINER(content_area), vbox);
+    gtk_notebook_append_page(GTK_NOTEBOOK(notebook), vbox, gtk_label_new("General"));
+    gtk_notebook_append_page(GTK_NOTEBOOK(notebook), create_performance_page(launcher),
+                             gtk_label_new("Performance"));
     
 /* Create icon selection row */
     hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
@@ -404,7 +683,74 @@ void launcher_show_settings_dialog(LauncherPlugin *launcher) {
     /* Store icon image reference for reset button callback */
     g_object_set_data(G_OBJECT(reset_button), "icon-image", icon_image);
     
+    /* Grid drawing mode */
+    drawn_grid_check = gtk_check_button_new_with_label("Draw application grid as a single widget");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(drawn_grid_check), launcher->drawn_grid);
+    gtk_widget_set_tooltip_text(drawn_grid_check,
+                                "Render all tiles in one widget instead of one button per application");
+    gtk_box_pack_start(GTK_BOX(vbox), drawn_grid_check, FALSE, FALSE, 0);
+    
+    /* Hot standby */
+    hot_standby_check = gtk_check_button_new_with_label("Keep the launcher ready while hidden");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(hot_standby_check), launcher->hot_standby);
+    gtk_widget_set_tooltip_text(hot_standby_check,
+                                "Prepare the first page in the background so the launcher opens instantly");
+    gtk_box_pack_start(GTK_BOX(vbox), hot_standby_check, FALSE, FALSE, 0);
+    
+    /* Page transition, only the drawn grid animates */
+    hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, FALSE, 0);
+    label = gtk_label_new("Page transition:");
+    gtk_box_pack_start(GTK_BOX(hbox), label, FALSE, FALSE, 0);
+    transition_combo = gtk_combo_box_text_new();
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(transition_combo), "None");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(transition_combo), "Slide");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(transition_combo), "Fade");
+    gtk_combo_box_set_active(GTK_COMBO_BOX(transition_combo), launcher->page_transition);
+    gtk_widget_set_tooltip_text(transition_combo,
+                                "Animation when switching pages, used with the single widget grid");
+    gtk_box_pack_start(GTK_BOX(hbox), transition_combo, FALSE, FALSE, 0);
+    
+    /* Frequent page */
+    frequent_page_check = gtk_check_button_new_with_label("Show frequently used applications first");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(frequent_page_check), launcher->frequent_page);
+    gtk_widget_set_tooltip_text(frequent_page_check,
+                                "Add a first page with the applications you started most recently and most often");
+    gtk_box_pack_start(GTK_BOX(vbox), frequent_page_check, FALSE, FALSE, 0);
+    
+    /* Readahead */
+    prefetch_check = gtk_check_button_new_with_label("Preload frequently used applications");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(prefetch_check), launcher->prefetch);
+    gtk_widget_set_tooltip_text(prefetch_check,
+                                "Read the programs you start most from disk while the launcher is open");
+    gtk_box_pack_start(GTK_BOX(vbox), prefetch_check, FALSE, FALSE, 0);
+    
+    /* Launch latency probe */
+    hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 12);
+    gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, FALSE, 0);
+    launch_probe_check = gtk_check_button_new_with_label("Measure application launch times");
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(launch_probe_check), launcher->launch_probe);
+    gtk_widget_set_tooltip_text(launch_probe_check,
+                                "Record the time from a click until the application's window appears");
+    gtk_box_pack_start(GTK_BOX(hbox), launch_probe_check, FALSE, FALSE, 0);
+    latency_button = gtk_button_new_with_label("Show...");
+    gtk_box_pack_start(GTK_BOX(hbox), latency_button, FALSE, FALSE, 0);
+    
     /* Connect signals */
+    g_signal_connect(frequent_page_check, "toggled",
+                     G_CALLBACK(on_frequent_page_toggled), launcher);
+    g_signal_connect(prefetch_check, "toggled",
+                     G_CALLBACK(on_prefetch_toggled), launcher);
+    g_signal_connect(launch_probe_check, "toggled",
+                     G_CALLBACK(on_launch_probe_toggled), launcher);
+    g_signal_connect(latency_button, "clicked",
+                     G_CALLBACK(on_latency_clicked), launcher);
+    g_signal_connect(transition_combo, "changed",
+                     G_CALLBACK(on_page_transition_changed), launcher);
+    g_signal_connect(hot_standby_check, "toggled",
+                     G_CALLBACK(on_hot_standby_toggled), launcher);
+    g_signal_connect(drawn_grid_check, "toggled",
+                     G_CALLBACK(on_drawn_grid_toggled), launcher);
     g_signal_connect(icon_button, "clicked",
                      G_CALLBACK(on_icon_button_clicked), launcher);
     g_signal_connect(reset_button, "clicked",
@@ -22,15 +22,58 @@
 /* Settings property names */
 #define XFCE_LAUNCHER_CHANNEL_NAME "xfce4-panel-launcher"
 #define SETTING_ICON_NAME "/icon-name"
+#define SETTING_DRAWN_GRID "/drawn-grid"
+#define SETTING_HOT_STANDBY "/hot-standby"
+#define SETTING_PAGE_TRANSITION "/page-transition"
+#define SETTING_LAUNCH_PROBE "/launch-probe"
+#define SETTING_PREFETCH "/prefetch"
+#define SETTING_FREQUENT_PAGE "/frequent-page"
+#define SETTING_ICON_CACHE_MB "/icon-cache-mb"
+#define SETTING_PRERENDER_DEPTH "/prerender-depth"
+#define SETTING_MONITOR_DEBOUNCE "/monitor-debounce-ms"
+#define SETTING_SEARCH_BACKEND "/search-backend"
+#define SETTING_WORKER_THREADS "/worker-threads"
+#define SETTING_TRACING "/tracing"
 
 /* Default values */
 #define DEFAULT_ICON_NAME "xfce-launcher"
+#define DEFAULT_DRAWN_GRID FALSE
+#define DEFAULT_HOT_STANDBY TRUE
+#define DEFAULT_PAGE_TRANSITION PAGE_TRANSITION_SLIDE
+#define DEFAULT_LAUNCH_PROBE FALSE
+#define DEFAULT_PREFETCH TRUE
+#define DEFAULT_FREQUENT_PAGE FALSE
+#define DEFAULT_ICON_CACHE_MB 64
+#define DEFAULT_PRERENDER_DEPTH 1
+#define DEFAULT_MONITOR_DEBOUNCE 250
+#define DEFAULT_SEARCH_BACKEND SEARCH_BACKEND_LINEAR
+#define DEFAULT_WORKER_THREADS 1
+#define DEFAULT_TRACING FALSE
+
+/* Ranges of the performance settings */
+#define MIN_ICON_CACHE_MB 8
+#define MAX_ICON_CACHE_MB 1024
+#define MAX_PRERENDER_DEPTH 4
+#define MAX_MONITOR_DEBOUNCE 5000
+#define MAX_WORKER_THREADS 8
 
 /* Settings functions */
 void launcher_settings_init(LauncherPlugin *launcher);
 void launcher_settings_free(LauncherPlugin *launcher);
 gchar* launcher_settings_get_icon_name(LauncherPlugin *launcher);
 void launcher_settings_set_icon_name(LauncherPlugin *launcher, const gchar *icon_name);
+void launcher_settings_set_drawn_grid(LauncherPlugin *launcher, gboolean drawn_grid);
+void launcher_settings_set_hot_standby(LauncherPlugin *launcher, gboolean hot_standby);
+void launcher_settings_set_page_transition(LauncherPlugin *launcher, PageTransition transition);
+void launcher_settings_set_launch_probe(LauncherPlugin *launcher, gboolean launch_probe);
+void launcher_settings_set_prefetch(LauncherPlugin *launcher, gboolean prefetch);
+void launcher_settings_set_frequent_page(LauncherPlugin *launcher, gboolean frequent_page);
+void launcher_settings_set_icon_cache_mb(LauncherPlugin *launcher, guint icon_cache_mb);
+void launcher_settings_set_prerender_depth(LauncherPlugin *launcher, guint depth);
+void launcher_settings_set_monitor_debounce(LauncherPlugin *launcher, guint debounce_ms);
+void launcher_settings_set_search_backend(LauncherPlugin *launcher, SearchBackend backend);
+void launcher_settings_set_worker_threads(LauncherPlugin *launcher, guint threads);
+void launcher_settings_set_tracing(LauncherPlugin *launcher, gboolean tracing);
 void launcher_show_settings_dialog(LauncherPlugin *launcher);
 
 #endif /* XFCE_LAUNCHER_SETTINGS_H */
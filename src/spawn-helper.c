@@ -0,0 +1,125 @@
+/*
+ * Spawn helper for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+/*
+ * A small process started by the plugin that launches applications on its
+ * behalf, so the large panel process never has to fork. Requests come in
+ * on a SOCK_SEQPACKET socket at fd 3, one launch per packet:
+ *
+ *   working directory \0 argc \0 argv[0] \0 ... argv[argc-1] \0 env \0 ...
+ *
+ * Every request is answered with an int32: the pid, or -errno on failure.
+ * The helper exits once the plugin closes its end of the socket.
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define REQUEST_FD 3
+#define MAX_REQUEST (256 * 1024)
+#define MAX_FIELDS 4096
+
+static char request[MAX_REQUEST];
+static char *fields[MAX_FIELDS + 1];
+static char *args[MAX_FIELDS + 1];
+
+/* Split a request into its NUL terminated fields, returns the count or -1 */
+static int split_fields(size_t len) {
+    size_t pos = 0;
+    int count = 0;
+
+    if (len == 0 || request[len - 1] != '\0')
+        return -1;
+
+    while (pos < len && count < MAX_FIELDS) {
+        fields[count++] = request + pos;
+        pos += strlen(request + pos) + 1;
+    }
+    fields[count] = NULL;
+
+    return pos == len ? count : -1;
+}
+
+static int32_t handle_request(size_t len) {
+    posix_spawnattr_t attr;
+    sigset_t signals;
+    int count, argc, err;
+    pid_t pid;
+
+    count = split_fields(len);
+    if (count < 3)
+        return -EINVAL;
+
+    argc = atoi(fields[1]);
+    if (argc < 1 || argc > count - 2)
+        return -EINVAL;
+
+    /* argv needs its own terminator, the environment ends with the fields */
+    memcpy(args, fields + 2, argc * sizeof(char *));
+    args[argc] = NULL;
+
+    /* Nothing else runs in the helper, the cwd is simply inherited */
+    if (fields[0][0] != '\0' && chdir(fields[0]) != 0 && chdir("/") != 0)
+        return -errno;
+
+    /* Applications get their own session and default signal handling */
+    posix_spawnattr_init(&attr);
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGCHLD);
+    sigaddset(&signals, SIGPIPE);
+    posix_spawnattr_setsigdefault(&attr, &signals);
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attr, &signals);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK |
+                                    POSIX_SPAWN_SETSID);
+
+    err = posix_spawn(&pid, args[0], NULL, &attr, args, fields + 2 + argc);
+    posix_spawnattr_destroy(&attr);
+
+    return err == 0 ? (int32_t)pid : -err;
+}
+
+int main(void) {
+    struct sigaction action;
+    ssize_t len;
+    int32_t reply;
+
+    /* The socket was dup2()ed to fd 3, which cleared close-on-exec. The
+     * applications must not inherit the connection to the panel */
+    if (fcntl(REQUEST_FD, F_SETFD, FD_CLOEXEC) != 0)
+        return 1;
+
+    /* Nobody waits for the applications, let the kernel reap them */
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_IGN;
+    action.sa_flags = SA_NOCLDWAIT;
+    sigaction(SIGCHLD, &action, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    for (;;) {
+        len = recv(REQUEST_FD, request, sizeof(request), MSG_TRUNC);
+        if (len < 0 && errno == EINTR)
+            continue;
+        if (len <= 0)
+            break;
+
+        reply = (size_t)len > sizeof(request) ? -E2BIG : handle_request((size_t)len);
+        if (send(REQUEST_FD, &reply, sizeof(reply), MSG_NOSIGNAL) < 0)
+            break;
+    }
+
+    return 0;
+}
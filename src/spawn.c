@@ -0,0 +1,337 @@
+/*
+ * Spawn helper client for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#define _GNU_SOURCE
+#include "xfce-launcher.h"
+#include <dlfcn.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <glib-unix.h>
+
+#define SPAWN_HELPER_NAME "xfce-launcher-spawn"
+
+/*
+ * Launches go to a helper process started with the plugin, see
+ * spawn-helper.c, so the panel with all its mappings is only forked once.
+ * Requests are answered in order; the queue remembers what each answer
+ * belongs to.
+ */
+typedef struct {
+    gchar             *name;
+    gchar             *app_id;
+    GAppLaunchContext *context;
+    gchar             *startup_id;
+    gint64            start;
+} SpawnRequest;
+
+static void spawn_request_free(SpawnRequest *request) {
+    g_free(request->name);
+    g_free(request->app_id);
+    g_clear_object(&request->context);
+    g_free(request->startup_id);
+    g_free(request);
+}
+
+/* The helper is installed next to the plugin library */
+static gchar* get_helper_path(void) {
+    Dl_info info;
+    gchar *dir, *path;
+
+    if (dladdr((void *)get_helper_path, &info) && info.dli_fname) {
+        dir = g_path_get_dirname(info.dli_fname);
+        path = g_build_filename(dir, SPAWN_HELPER_NAME, NULL);
+        g_free(dir);
+        if (g_file_test(path, G_FILE_TEST_IS_EXECUTABLE))
+            return path;
+        g_free(path);
+    }
+
+    return g_find_program_in_path(SPAWN_HELPER_NAME);
+}
+
+static void drop_helper(LauncherPlugin *launcher) {
+    if (launcher->spawn_watch) {
+        g_source_remove(launcher->spawn_watch);
+        launcher->spawn_watch = 0;
+    }
+    if (launcher->spawn_fd >= 0) {
+        close(launcher->spawn_fd);
+        launcher->spawn_fd = -1;
+    }
+    g_clear_object(&launcher->spawn_helper);
+
+    /* Requests the helper never answered, their busy cursors stop */
+    if (launcher->spawn_pending) {
+        SpawnRequest *request;
+
+        while ((request = g_queue_pop_head(launcher->spawn_pending))) {
+            if (request->startup_id)
+                g_app_launch_context_launch_failed(request->context, request->startup_id);
+            spawn_request_free(request);
+        }
+    }
+}
+
+static gboolean on_helper_reply(gint fd, GIOCondition condition, gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+    SpawnRequest *request;
+    gint32 reply;
+
+    if (condition & (G_IO_HUP | G_IO_ERR)) {
+        g_warning("Spawn helper went away, launching directly from now on");
+        launcher->spawn_watch = 0;
+        drop_helper(launcher);
+        return G_SOURCE_REMOVE;
+    }
+
+    while (recv(fd, &reply, sizeof(reply), MSG_DONTWAIT) == sizeof(reply)) {
+        request = g_queue_pop_head(launcher->spawn_pending);
+        if (!request)
+            continue;
+
+        if (reply > 0) {
+            g_debug("Launch: %s spawned by the helper in %.2f ms", request->name,
+                    (g_get_monotonic_time() - request->start) / 1000.0);
+            probe_launch_started(launcher, request->app_id, request->startup_id, reply, request->start);
+        } else {
+            g_warning("Failed to launch application: %s", g_strerror(-reply));
+            notify_launch_error(request->name, g_strerror(-reply));
+            if (request->startup_id)
+                g_app_launch_context_launch_failed(request->context, request->startup_id);
+        }
+        spawn_request_free(request);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_helper_exited(GObject *source, GAsyncResult *result, gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+    GError *error = NULL;
+
+    /* Cancelled when the plugin goes away, the launcher is gone by then */
+    if (!g_subprocess_wait_finish(G_SUBPROCESS(source), result, &error) &&
+        g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        g_error_free(error);
+        return;
+    }
+    g_clear_error(&error);
+
+    if (launcher->spawn_helper == G_SUBPROCESS(source)) {
+        g_warning("Spawn helper exited, launching directly from now on");
+        drop_helper(launcher);
+    }
+}
+
+void spawn_helper_start(LauncherPlugin *launcher) {
+    GSubprocessLauncher *subprocess_launcher;
+    GError *error = NULL;
+    gchar *path = get_helper_path();
+    gint fds[2];
+
+    launcher->spawn_fd = -1;
+    if (!path) {
+        g_debug("Spawn helper not installed, launching directly");
+        return;
+    }
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0) {
+        g_warning("Spawn helper: socketpair failed: %s", g_strerror(errno));
+        g_free(path);
+        return;
+    }
+
+    /* The one fork of the panel, everything later is spawned by the helper */
+    subprocess_launcher = g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_NONE);
+    g_subprocess_launcher_take_fd(subprocess_launcher, fds[1], 3);
+    launcher->spawn_helper = g_subprocess_launcher_spawn(subprocess_launcher, &error, path, NULL);
+    g_object_unref(subprocess_launcher);
+
+    if (!launcher->spawn_helper) {
+        g_warning("Spawn helper: %s", error->message);
+        g_error_free(error);
+        close(fds[0]);
+        g_free(path);
+        return;
+    }
+
+    launcher->spawn_fd = fds[0];
+    launcher->spawn_pending = g_queue_new();
+    launcher->spawn_watch = g_unix_fd_add(launcher->spawn_fd, G_IO_IN | G_IO_HUP | G_IO_ERR,
+                                          on_helper_reply, launcher);
+    g_subprocess_wait_async(launcher->spawn_helper, launcher->launch_cancellable,
+                            on_helper_exited, launcher);
+    g_free(path);
+}
+
+void spawn_helper_stop(LauncherPlugin *launcher) {
+    /* Closing the socket ends the helper */
+    drop_helper(launcher);
+    if (launcher->spawn_pending) {
+        g_queue_free(launcher->spawn_pending);
+        launcher->spawn_pending = NULL;
+    }
+}
+
+/* Expand the Exec field codes for a launch without files or URIs */
+static gboolean expand_exec(GDesktopAppInfo *info, GPtrArray *args) {
+    const gchar *exec = g_app_info_get_commandline(G_APP_INFO(info));
+    gchar **argv = NULL;
+    gchar *program;
+    gint argc, i;
+
+    if (!exec || !g_shell_parse_argv(exec, &argc, &argv, NULL))
+        return FALSE;
+
+    for (i = 0; i < argc; i++) {
+        const gchar *arg = argv[i];
+        GString *expanded;
+
+        if (strcmp(arg, "%i") == 0) {
+            gchar *icon = g_desktop_app_info_get_string(info, "Icon");
+            if (icon) {
+                g_ptr_array_add(args, g_strdup("--icon"));
+                g_ptr_array_add(args, icon);
+            }
+            continue;
+        }
+
+        expanded = g_string_new(NULL);
+        for (; *arg; arg++) {
+            if (*arg != '%' || !arg[1]) {
+                g_string_append_c(expanded, *arg);
+                continue;
+            }
+            switch (*++arg) {
+                case '%':
+                    g_string_append_c(expanded, '%');
+                    break;
+                case 'c':
+                    g_string_append(expanded, g_app_info_get_name(G_APP_INFO(info)));
+                    break;
+                case 'k':
+                    if (g_desktop_app_info_get_filename(info))
+                        g_string_append(expanded, g_desktop_app_info_get_filename(info));
+                    break;
+                default:
+                    /* %f %u %F %U and deprecated codes expand to nothing without files */
+                    break;
+            }
+        }
+
+        /* A lone file code disappears instead of leaving an empty argument */
+        if (expanded->len > 0 || strchr(argv[i], '%') == NULL)
+            g_ptr_array_add(args, g_string_free(expanded, FALSE));
+        else
+            g_string_free(expanded, TRUE);
+    }
+    g_strfreev(argv);
+
+    if (args->len == 0)
+        return FALSE;
+
+    /* The helper does no PATH lookup of its own */
+    program = g_find_program_in_path(g_ptr_array_index(args, 0));
+    if (!program)
+        return FALSE;
+    g_free(g_ptr_array_index(args, 0));
+    g_ptr_array_index(args, 0) = program;
+
+    return TRUE;
+}
+
+/*
+ * Hand a launch to the helper. Returns FALSE when it cannot take it: no
+ * helper, or an application GLib has to start itself (terminal apps,
+ * D-Bus activation, an Exec line we cannot resolve); the caller then
+ * launches directly.
+ */
+gboolean spawn_helper_launch(LauncherPlugin *launcher, GDesktopAppInfo *info, const gchar *app_id,
+                             GAppLaunchContext *context) {
+    GPtrArray *args;
+    GByteArray *message;
+    SpawnRequest *request;
+    gchar **envp;
+    gchar *path, *argc_str;
+    guint i;
+
+    if (launcher->spawn_fd < 0 ||
+        g_desktop_app_info_get_boolean(info, "Terminal") ||
+        g_desktop_app_info_get_boolean(info, "DBusActivatable"))
+        return FALSE;
+
+    args = g_ptr_array_new_with_free_func(g_free);
+    if (!expand_exec(info, args)) {
+        g_ptr_array_unref(args);
+        return FALSE;
+    }
+
+    request = g_new0(SpawnRequest, 1);
+    request->name = g_strdup(g_app_info_get_name(G_APP_INFO(info)));
+    request->app_id = g_strdup(app_id);
+    request->context = g_object_ref(context);
+    request->start = g_get_monotonic_time();
+
+    envp = g_app_launch_context_get_environment(context);
+    if (g_desktop_app_info_get_boolean(info, "StartupNotify")) {
+        request->startup_id = g_app_launch_context_get_startup_notify_id(context, G_APP_INFO(info), NULL);
+        if (request->startup_id) {
+            envp = g_environ_setenv(envp, "DESKTOP_STARTUP_ID", request->startup_id, TRUE);
+            envp = g_environ_setenv(envp, "XDG_ACTIVATION_TOKEN", request->startup_id, TRUE);
+        }
+    }
+    if (g_desktop_app_info_get_filename(info))
+        envp = g_environ_setenv(envp, "GIO_LAUNCHED_DESKTOP_FILE",
+                                g_desktop_app_info_get_filename(info), TRUE);
+
+    /* Working directory, environment and command line in one packet */
+    path = g_desktop_app_info_get_string(info, "Path");
+    if (!path || !*path) {
+        g_free(path);
+        path = g_get_current_dir();
+    }
+    argc_str = g_strdup_printf("%u", args->len);
+
+    message = g_byte_array_new();
+    g_byte_array_append(message, (const guint8 *)path, strlen(path) + 1);
+    g_byte_array_append(message, (const guint8 *)argc_str, strlen(argc_str) + 1);
+    for (i = 0; i < args->len; i++) {
+        const gchar *arg = g_ptr_array_index(args, i);
+        g_byte_array_append(message, (const guint8 *)arg, strlen(arg) + 1);
+    }
+    for (i = 0; envp && envp[i]; i++)
+        g_byte_array_append(message, (const guint8 *)envp[i], strlen(envp[i]) + 1);
+
+    if (send(launcher->spawn_fd, message->data, message->len, MSG_NOSIGNAL | MSG_DONTWAIT) ==
+        (gssize)message->len) {
+        g_queue_push_tail(launcher->spawn_pending, request);
+        request = NULL;
+    } else {
+        gint saved_errno = errno;
+
+        g_warning("Spawn helper: %s, launching directly", g_strerror(saved_errno));
+        /* A dead helper stays dead, an oversized request only falls back once */
+        if (saved_errno == EPIPE || saved_errno == ECONNRESET)
+            drop_helper(launcher);
+        if (request->startup_id)
+            g_app_launch_context_launch_failed(context, request->startup_id);
+    }
+
+    g_byte_array_unref(message);
+    g_free(argc_str);
+    g_free(path);
+    g_strfreev(envp);
+    g_ptr_array_unref(args);
+
+    if (request) {
+        spawn_request_free(request);
+        return FALSE;
+    }
+    return TRUE;
+}
@@ -0,0 +1,164 @@
+/*
+ * Theme management for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+
+/* Providers are parsed once per process and only attached to launcher widgets,
+ * so the rest of the panel never matches or restyles against them */
+static GtkCssProvider *base_provider = NULL;
+static GtkCssProvider *button_provider = NULL;
+static GtkCssProvider *user_provider = NULL;
+static GFileMonitor *user_monitor = NULL;
+static gint theme_users = 0;
+/* Launcher style contexts alive, the ones a theme reload restyles */
+static guint themed_contexts = 0;
+
+static const gchar *button_css =
+    "#xfce-launcher-button {\n"
+    "  background: transparent;\n"
+    "  background-color: transparent;\n"
+    "  background-image: none;\n"
+    "  border: none;\n"
+    "  outline: none;\n"
+    "  padding: 0px;\n"
+    "  margin: 0px;\n"
+    "  min-width: 16px;\n"
+    "  min-height: 16px;\n"
+    "}\n"
+    "#xfce-launcher-button:hover {\n"
+    "  background-color: rgba(255, 255, 255, 0.1);\n"
+    "  background-image: none;\n"
+    "}\n"
+    "#xfce-launcher-button:active {\n"
+    "  background-color: rgba(255, 255, 255, 0.2);\n"
+    "  background-image: none;\n"
+    "}\n"
+    ".xfce4-panel #xfce-launcher-button {\n"
+    "  background: transparent;\n"
+    "  background-color: transparent;\n"
+    "}\n";
+
+gchar* get_user_theme_path(void) {
+    return g_build_filename(g_get_user_config_dir(), "xfce4", "launcher", "theme.css", NULL);
+}
+
+static void on_parsing_error(GtkCssProvider *provider, GtkCssSection *section,
+                             GError *error, gpointer data) {
+    g_warning("Theme: line %u: %s",
+              gtk_css_section_get_start_line(section) + 1, error->message);
+}
+
+/* (Re)load the user theme, an absent file means no overrides */
+static void load_user_theme(void) {
+    gchar *path = get_user_theme_path();
+    gint64 start = g_get_monotonic_time();
+
+    /* Loading emits "changed", which invalidates only the contexts using the provider */
+    if (g_file_test(path, G_FILE_TEST_IS_REGULAR))
+        gtk_css_provider_load_from_path(user_provider, path, NULL);
+    else
+        gtk_css_provider_load_from_data(user_provider, "", -1, NULL);
+
+    g_debug("Theme: loaded %s in %.2f ms, %u launcher style contexts invalidated",
+            path, (g_get_monotonic_time() - start) / 1000.0, themed_contexts);
+    g_free(path);
+}
+
+static void on_user_theme_changed(GFileMonitor *monitor, GFile *file, GFile *other_file,
+                                  GFileMonitorEvent event_type, gpointer data) {
+    if (event_type == G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT ||
+        event_type == G_FILE_MONITOR_EVENT_CREATED ||
+        event_type == G_FILE_MONITOR_EVENT_DELETED) {
+        load_user_theme();
+    }
+}
+
+void theme_acquire(void) {
+    gchar *path;
+    GFile *file;
+    gint64 start;
+
+    if (theme_users++ > 0)
+        return;
+
+    start = g_get_monotonic_time();
+
+    base_provider = gtk_css_provider_new();
+    g_signal_connect(base_provider, "parsing-error", G_CALLBACK(on_parsing_error), NULL);
+    gtk_css_provider_load_from_data(base_provider, get_css_style(), -1, NULL);
+
+    button_provider = gtk_css_provider_new();
+    gtk_css_provider_load_from_data(button_provider, button_css, -1, NULL);
+
+    g_debug("Theme: built-in styles parsed in %.2f ms",
+            (g_get_monotonic_time() - start) / 1000.0);
+
+    user_provider = gtk_css_provider_new();
+    g_signal_connect(user_provider, "parsing-error", G_CALLBACK(on_parsing_error), NULL);
+    load_user_theme();
+
+    /* Watch the user theme so edits apply without a panel restart */
+    path = get_user_theme_path();
+    file = g_file_new_for_path(path);
+    user_monitor = g_file_monitor_file(file, G_FILE_MONITOR_NONE, NULL, NULL);
+    if (user_monitor)
+        g_signal_connect(user_monitor, "changed", G_CALLBACK(on_user_theme_changed), NULL);
+    g_object_unref(file);
+    g_free(path);
+}
+
+void theme_release(void) {
+    if (theme_users == 0 || --theme_users > 0)
+        return;
+
+    g_clear_object(&user_monitor);
+    g_clear_object(&base_provider);
+    g_clear_object(&button_provider);
+    g_clear_object(&user_provider);
+    themed_contexts = 0;
+}
+
+static void on_themed_context_finalized(gpointer data, GObject *context) {
+    if (themed_contexts > 0)
+        themed_contexts--;
+}
+
+/* Attach the launcher styles to a single style context */
+void theme_apply_context(GtkStyleContext *context) {
+    gtk_style_context_add_provider(context, GTK_STYLE_PROVIDER(base_provider),
+                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    gtk_style_context_add_provider(context, GTK_STYLE_PROVIDER(user_provider),
+                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
+    g_object_weak_ref(G_OBJECT(context), on_themed_context_finalized, NULL);
+    themed_contexts++;
+}
+
+static void apply_to_widget(GtkWidget *widget, gpointer data) {
+    if (!g_object_get_data(G_OBJECT(widget), "launcher-themed")) {
+        g_object_set_data(G_OBJECT(widget), "launcher-themed", GINT_TO_POINTER(TRUE));
+        theme_apply_context(gtk_widget_get_style_context(widget));
+    }
+
+    if (GTK_IS_CONTAINER(widget))
+        gtk_container_forall(GTK_CONTAINER(widget), apply_to_widget, NULL);
+}
+
+/* Attach the launcher styles to a widget and everything inside it */
+void theme_apply(GtkWidget *widget) {
+    apply_to_widget(widget, NULL);
+}
+
+/* Style the panel button, the user theme may override it as well */
+void theme_apply_button(GtkWidget *button) {
+    GtkStyleContext *context = gtk_widget_get_style_context(button);
+
+    gtk_style_context_add_provider(context, GTK_STYLE_PROVIDER(button_provider),
+                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 1);
+    gtk_style_context_add_provider(context, GTK_STYLE_PROVIDER(user_provider),
+                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 2);
+}
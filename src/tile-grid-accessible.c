@@ -0,0 +1,339 @@
+/*
+ * Accessibility of the custom drawn grid for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <gtk/gtk-a11y.h>
+
+/*
+ * The drawn grid has no child widgets, so its accessible makes up one
+ * child per tile, as the buttons of the widget grid would be. Children
+ * are created when an assistive technology asks for them and dropped
+ * when the grid shows other items; names and states are read from the
+ * grid each time, so a moved tile needs no new child. Until something
+ * asks for the grid's accessible, none is created and nothing is sent.
+ */
+
+typedef struct {
+    GtkWidgetAccessible parent;
+    GPtrArray           *tiles;
+} TileGridAccessible;
+
+typedef struct {
+    GtkWidgetAccessibleClass parent_class;
+} TileGridAccessibleClass;
+
+typedef struct {
+    AtkObject parent;
+    gint      index;
+} TileAccessible;
+
+typedef struct {
+    AtkObjectClass parent_class;
+} TileAccessibleClass;
+
+static void tile_accessible_component_init(AtkComponentIface *iface);
+static void tile_accessible_action_init(AtkActionIface *iface);
+
+G_DEFINE_TYPE(TileGridAccessible, tile_grid_accessible, GTK_TYPE_WIDGET_ACCESSIBLE)
+G_DEFINE_TYPE_WITH_CODE(TileAccessible, tile_accessible, ATK_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(ATK_TYPE_COMPONENT, tile_accessible_component_init)
+                        G_IMPLEMENT_INTERFACE(ATK_TYPE_ACTION, tile_accessible_action_init))
+
+#define ACCESSIBLE_KEY "tile-grid-accessible"
+
+/* The accessible of a grid if one was asked for, without creating it */
+static TileGridAccessible* lookup_accessible(GtkWidget *widget) {
+    return g_object_get_data(G_OBJECT(widget), ACCESSIBLE_KEY);
+}
+
+/* Grid widget of a tile, NULL once the tile or the grid is gone */
+static GtkWidget* get_tile_widget(TileAccessible *tile) {
+    AtkObject *parent = atk_object_get_parent(ATK_OBJECT(tile));
+
+    if (tile->index < 0 || !parent || !GTK_IS_ACCESSIBLE(parent))
+        return NULL;
+    return gtk_accessible_get_widget(GTK_ACCESSIBLE(parent));
+}
+
+static const gchar* tile_accessible_get_name(AtkObject *object) {
+    TileAccessible *tile = (TileAccessible *)object;
+    GtkWidget *widget = get_tile_widget(tile);
+
+    if (object->name)
+        return object->name;
+    return widget ? tile_grid_get_item_name(widget, tile->index) : NULL;
+}
+
+static gint tile_accessible_get_index_in_parent(AtkObject *object) {
+    return ((TileAccessible *)object)->index;
+}
+
+static AtkStateSet* tile_accessible_ref_state_set(AtkObject *object) {
+    TileAccessible *tile = (TileAccessible *)object;
+    GtkWidget *widget = get_tile_widget(tile);
+    AtkStateSet *states = atk_state_set_new();
+
+    if (!widget) {
+        atk_state_set_add_state(states, ATK_STATE_DEFUNCT);
+        return states;
+    }
+
+    atk_state_set_add_state(states, ATK_STATE_ENABLED);
+    atk_state_set_add_state(states, ATK_STATE_SENSITIVE);
+    atk_state_set_add_state(states, ATK_STATE_FOCUSABLE);
+    atk_state_set_add_state(states, ATK_STATE_SELECTABLE);
+    atk_state_set_add_state(states, ATK_STATE_VISIBLE);
+    if (gtk_widget_get_mapped(widget))
+        atk_state_set_add_state(states, ATK_STATE_SHOWING);
+
+    if (tile->index == tile_grid_get_selection(widget)) {
+        atk_state_set_add_state(states, ATK_STATE_SELECTED);
+        if (gtk_widget_has_focus(widget))
+            atk_state_set_add_state(states, ATK_STATE_FOCUSED);
+    }
+
+    return states;
+}
+
+static void tile_accessible_class_init(TileAccessibleClass *klass) {
+    AtkObjectClass *atk_class = ATK_OBJECT_CLASS(klass);
+
+    atk_class->get_name = tile_accessible_get_name;
+    atk_class->get_index_in_parent = tile_accessible_get_index_in_parent;
+    atk_class->ref_state_set = tile_accessible_ref_state_set;
+}
+
+static void tile_accessible_init(TileAccessible *tile) {
+    tile->index = -1;
+}
+
+/* The tile rectangle offset by where the grid itself is */
+static void tile_accessible_get_extents(AtkComponent *component, gint *x, gint *y,
+                                        gint *width, gint *height, AtkCoordType coord_type) {
+    TileAccessible *tile = (TileAccessible *)component;
+    GtkWidget *widget = get_tile_widget(tile);
+    AtkObject *parent = atk_object_get_parent(ATK_OBJECT(component));
+    GdkRectangle rect;
+    gint grid_x, grid_y;
+
+    if (!widget) {
+        *x = *y = *width = *height = -1;
+        return;
+    }
+
+    atk_component_get_extents(ATK_COMPONENT(parent), &grid_x, &grid_y, NULL, NULL, coord_type);
+    tile_grid_get_tile_rect(widget, tile->index, &rect);
+    *x = grid_x + rect.x;
+    *y = grid_y + rect.y;
+    *width = rect.width;
+    *height = rect.height;
+}
+
+static gboolean tile_accessible_grab_focus(AtkComponent *component) {
+    TileAccessible *tile = (TileAccessible *)component;
+    GtkWidget *widget = get_tile_widget(tile);
+
+    if (!widget)
+        return FALSE;
+
+    tile_grid_focus_tile(widget, tile->index);
+    return TRUE;
+}
+
+static void tile_accessible_component_init(AtkComponentIface *iface) {
+    iface->get_extents = tile_accessible_get_extents;
+    iface->grab_focus = tile_accessible_grab_focus;
+}
+
+/* One action, the click that launches the app or opens the folder */
+static gint tile_accessible_get_n_actions(AtkAction *action) {
+    return 1;
+}
+
+static const gchar* tile_accessible_action_get_name(AtkAction *action, gint i) {
+    return i == 0 ? "click" : NULL;
+}
+
+static gboolean tile_accessible_do_action(AtkAction *action, gint i) {
+    TileAccessible *tile = (TileAccessible *)action;
+    GtkWidget *widget = get_tile_widget(tile);
+
+    if (i != 0 || !widget)
+        return FALSE;
+
+    tile_grid_activate(widget, tile->index);
+    return TRUE;
+}
+
+static void tile_accessible_action_init(AtkActionIface *iface) {
+    iface->get_n_actions = tile_accessible_get_n_actions;
+    iface->get_name = tile_accessible_action_get_name;
+    iface->do_action = tile_accessible_do_action;
+}
+
+/* Let go of the children, they report defunct to whoever still holds them */
+static void clear_tiles(TileGridAccessible *self, gboolean notify) {
+    guint i;
+
+    for (i = 0; i < self->tiles->len; i++) {
+        TileAccessible *tile = g_ptr_array_index(self->tiles, i);
+
+        if (!tile)
+            continue;
+
+        tile->index = -1;
+        if (notify) {
+            atk_object_notify_state_change(ATK_OBJECT(tile), ATK_STATE_DEFUNCT, TRUE);
+            g_signal_emit_by_name(self, "children-changed::remove", i, tile);
+        }
+        atk_object_set_parent(ATK_OBJECT(tile), NULL);
+        g_object_unref(tile);
+    }
+    g_ptr_array_set_size(self->tiles, 0);
+}
+
+static gint tile_grid_accessible_get_n_children(AtkObject *object) {
+    GtkWidget *widget = gtk_accessible_get_widget(GTK_ACCESSIBLE(object));
+
+    return widget ? tile_grid_get_item_count(widget) : 0;
+}
+
+static AtkObject* tile_grid_accessible_ref_child(AtkObject *object, gint i) {
+    TileGridAccessible *self = (TileGridAccessible *)object;
+    GtkWidget *widget = gtk_accessible_get_widget(GTK_ACCESSIBLE(object));
+    TileAccessible *tile;
+
+    if (!widget || i < 0 || i >= tile_grid_get_item_count(widget))
+        return NULL;
+
+    if ((guint)i >= self->tiles->len)
+        g_ptr_array_set_size(self->tiles, i + 1);
+
+    tile = g_ptr_array_index(self->tiles, i);
+    if (!tile) {
+        tile = g_object_new(tile_accessible_get_type(), NULL);
+        tile->index = i;
+        atk_object_initialize(ATK_OBJECT(tile), NULL);
+        atk_object_set_role(ATK_OBJECT(tile), ATK_ROLE_LIST_ITEM);
+        atk_object_set_parent(ATK_OBJECT(tile), object);
+        g_ptr_array_index(self->tiles, i) = tile;
+    }
+
+    return g_object_ref(ATK_OBJECT(tile));
+}
+
+static void tile_grid_accessible_initialize(AtkObject *object, gpointer data) {
+    ATK_OBJECT_CLASS(tile_grid_accessible_parent_class)->initialize(object, data);
+
+    atk_object_set_role(object, ATK_ROLE_LIST);
+    atk_object_set_name(object, "Applications");
+
+    /* Data is the grid, which owns the accessible from now on */
+    g_object_set_data(G_OBJECT(data), ACCESSIBLE_KEY, object);
+}
+
+/* The children hold their parent, the widget going away breaks the cycle */
+static void tile_grid_accessible_widget_unset(GtkAccessible *accessible) {
+    GtkWidget *widget = gtk_accessible_get_widget(accessible);
+
+    if (widget)
+        g_object_set_data(G_OBJECT(widget), ACCESSIBLE_KEY, NULL);
+    clear_tiles((TileGridAccessible *)accessible, FALSE);
+
+    if (GTK_ACCESSIBLE_CLASS(tile_grid_accessible_parent_class)->widget_unset)
+        GTK_ACCESSIBLE_CLASS(tile_grid_accessible_parent_class)->widget_unset(accessible);
+}
+
+static void tile_grid_accessible_finalize(GObject *object) {
+    TileGridAccessible *self = (TileGridAccessible *)object;
+
+    clear_tiles(self, FALSE);
+    g_ptr_array_unref(self->tiles);
+
+    G_OBJECT_CLASS(tile_grid_accessible_parent_class)->finalize(object);
+}
+
+static void tile_grid_accessible_class_init(TileGridAccessibleClass *klass) {
+    AtkObjectClass *atk_class = ATK_OBJECT_CLASS(klass);
+
+    G_OBJECT_CLASS(klass)->finalize = tile_grid_accessible_finalize;
+    GTK_ACCESSIBLE_CLASS(klass)->widget_unset = tile_grid_accessible_widget_unset;
+    atk_class->initialize = tile_grid_accessible_initialize;
+    atk_class->get_n_children = tile_grid_accessible_get_n_children;
+    atk_class->ref_child = tile_grid_accessible_ref_child;
+}
+
+static void tile_grid_accessible_init(TileGridAccessible *self) {
+    self->tiles = g_ptr_array_new();
+}
+
+/* The grid shows other items: old children go, count new ones are announced */
+void tile_grid_accessible_items_changed(GtkWidget *widget, gint count) {
+    TileGridAccessible *self = lookup_accessible(widget);
+    gint i;
+
+    if (!self)
+        return;
+
+    clear_tiles(self, TRUE);
+    /* The bridge reads the added child, it must be a real one */
+    for (i = 0; i < count; i++) {
+        AtkObject *tile = atk_object_ref_accessible_child(ATK_OBJECT(self), i);
+
+        if (!tile)
+            break;
+        g_signal_emit_by_name(self, "children-changed::add", i, tile);
+        g_object_unref(tile);
+    }
+}
+
+/* Items from first on were replaced in place, their children read the new names */
+void tile_grid_accessible_names_changed(GtkWidget *widget, gint first, gint count) {
+    TileGridAccessible *self = lookup_accessible(widget);
+    gint i;
+
+    if (!self)
+        return;
+
+    for (i = first; i < first + count && i < (gint)self->tiles->len; i++) {
+        AtkObject *tile = g_ptr_array_index(self->tiles, i);
+        if (tile)
+            g_object_notify(G_OBJECT(tile), "accessible-name");
+    }
+}
+
+/* The highlighted tile moved from old_index to index, either may be -1 */
+void tile_grid_accessible_selection_changed(GtkWidget *widget, gint old_index, gint index) {
+    TileGridAccessible *self = lookup_accessible(widget);
+    AtkObject *accessible, *tile;
+
+    if (!self)
+        return;
+    accessible = ATK_OBJECT(self);
+
+    if (old_index >= 0 && old_index < (gint)self->tiles->len &&
+        (tile = g_ptr_array_index(self->tiles, old_index))) {
+        atk_object_notify_state_change(tile, ATK_STATE_SELECTED, FALSE);
+        atk_object_notify_state_change(tile, ATK_STATE_FOCUSED, FALSE);
+    }
+
+    if (index < 0)
+        return;
+
+    /* Screen readers follow the keyboard through the active descendant */
+    tile = atk_object_ref_accessible_child(accessible, index);
+    if (!tile)
+        return;
+
+    atk_object_notify_state_change(tile, ATK_STATE_SELECTED, TRUE);
+    if (gtk_widget_has_focus(widget)) {
+        atk_object_notify_state_change(tile, ATK_STATE_FOCUSED, TRUE);
+        g_signal_emit_by_name(accessible, "active-descendant-changed", tile);
+    }
+    g_object_unref(tile);
+}
@@ -0,0 +1,877 @@
+/*
+ * Custom drawn application grid for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+#include <math.h>
+
+/* Tile geometry, mirrors the app-button CSS used by the widget grid */
+#define TILE_PADDING 15
+#define LABEL_SPACING 8
+
+/* Upper bound of shaped labels kept around, roughly a large catalog */
+#define LAYOUT_CACHE_SIZE 2048
+
+/* Label shaping allowed per frame, the remaining labels follow in the next frames */
+#define LABEL_SHAPE_BUDGET_US 3000
+
+/* Page transitions */
+#define TRANSITION_DURATION_US 220000
+#define SETTLE_MIN_US 80000
+#define SETTLE_MAX_US 300000
+/* Swipe speed in px/s that flips the page even short of half way */
+#define SWIPE_FLICK_VELOCITY 400.0
+
+typedef struct {
+    LauncherPlugin  *launcher;
+    GArray          *items;
+    gint            hover_index;
+    gint            focus_index;
+    gint            press_index;
+    GtkStyleContext *app_context;
+    GtkStyleContext *folder_context;
+    GtkStyleContext *label_context;
+    GHashTable      *layouts;
+    PangoFontDescription *label_font;
+    gchar           *label_font_name;
+    gboolean        labels_deferred;
+    /* Page transition, animated on snapshots instead of live tiles */
+    cairo_surface_t *out_surface;
+    cairo_surface_t *in_surface;
+    gboolean        render_incoming;
+    gboolean        tracking;
+    gint            direction;
+    gint            target_page;
+    gdouble         progress;
+    gdouble         from_progress;
+    gdouble         to_progress;
+    gint64          start_time;
+    gint64          duration;
+    guint           tick_id;
+} TileGrid;
+
+static void tile_grid_free(TileGrid *grid) {
+    g_array_unref(grid->items);
+    g_hash_table_destroy(grid->layouts);
+    if (grid->label_font)
+        pango_font_description_free(grid->label_font);
+    g_free(grid->label_font_name);
+    g_clear_object(&grid->app_context);
+    g_clear_object(&grid->folder_context);
+    g_clear_object(&grid->label_context);
+    g_clear_pointer(&grid->out_surface, cairo_surface_destroy);
+    g_clear_pointer(&grid->in_surface, cairo_surface_destroy);
+    g_free(grid);
+}
+
+static TileGrid* get_tile_grid(GtkWidget *widget) {
+    return g_object_get_data(G_OBJECT(widget), "tile-grid");
+}
+
+static void get_tile_rect(TileGrid *grid, gint index, GdkRectangle *rect) {
+    const GridLayout *layout = &grid->launcher->layout;
+
+    rect->x = (index % layout->columns) * layout->pitch + TILE_MARGIN;
+    rect->y = (index / layout->columns) * layout->pitch + TILE_MARGIN;
+    rect->width = layout->button_size;
+    rect->height = layout->button_size;
+}
+
+static gint get_tile_at(TileGrid *grid, gdouble x, gdouble y) {
+    const GridLayout *layout = &grid->launcher->layout;
+    gint col, row, index;
+    gint offset_x, offset_y;
+
+    if (x < 0 || y < 0)
+        return -1;
+
+    col = (gint)x / layout->pitch;
+    row = (gint)y / layout->pitch;
+    offset_x = (gint)x % layout->pitch;
+    offset_y = (gint)y % layout->pitch;
+
+    /* Margins and spacing between tiles are not part of any tile */
+    if (col >= layout->columns || row >= layout->rows ||
+        offset_x < TILE_MARGIN || offset_x >= TILE_MARGIN + layout->button_size ||
+        offset_y < TILE_MARGIN || offset_y >= TILE_MARGIN + layout->button_size)
+        return -1;
+
+    index = row * layout->columns + col;
+    return index < (gint)grid->items->len ? index : -1;
+}
+
+static void invalidate_tile(GtkWidget *widget, gint index) {
+    GdkRectangle rect;
+
+    if (index < 0)
+        return;
+
+    get_tile_rect(get_tile_grid(widget), index, &rect);
+    gtk_widget_queue_draw_area(widget, rect.x, rect.y, rect.width, rect.height);
+}
+
+static const gchar* get_item_name(const GridItem *item) {
+    return item->folder_info ? item->folder_info->name : item->app_info->name;
+}
+
+/* Create a style context matching the nodes the widget grid would have */
+static GtkStyleContext* create_tile_context(GtkWidget *widget, const gchar *style_class, gboolean label) {
+    GtkWidgetPath *path = gtk_widget_path_copy(gtk_widget_get_path(widget));
+    GtkStyleContext *context = gtk_style_context_new();
+    gint pos;
+
+    pos = gtk_widget_path_append_type(path, GTK_TYPE_BUTTON);
+    gtk_widget_path_iter_add_class(path, pos, style_class);
+    if (label)
+        gtk_widget_path_append_type(path, GTK_TYPE_LABEL);
+
+    gtk_style_context_set_path(context, path);
+    gtk_style_context_set_parent(context, gtk_widget_get_style_context(widget));
+    gtk_widget_path_unref(path);
+    theme_apply_context(context);
+
+    return context;
+}
+
+/* Pick up the label font, dropping shaped layouts when it changed */
+static void sync_label_font(TileGrid *grid) {
+    PangoFontDescription *font = NULL;
+    gchar *font_name;
+
+    gtk_style_context_get(grid->label_context, GTK_STATE_FLAG_NORMAL, "font", &font, NULL);
+    font_name = pango_font_description_to_string(font);
+
+    if (g_strcmp0(font_name, grid->label_font_name) == 0) {
+        pango_font_description_free(font);
+        g_free(font_name);
+        return;
+    }
+
+    g_hash_table_remove_all(grid->layouts);
+    if (grid->label_font)
+        pango_font_description_free(grid->label_font);
+    g_free(grid->label_font_name);
+    grid->label_font = font;
+    grid->label_font_name = font_name;
+}
+
+static void ensure_style_contexts(TileGrid *grid, GtkWidget *widget) {
+    if (grid->app_context)
+        return;
+
+    grid->app_context = create_tile_context(widget, "app-button", FALSE);
+    grid->folder_context = create_tile_context(widget, "folder", FALSE);
+    grid->label_context = create_tile_context(widget, "app-button", TRUE);
+    sync_label_font(grid);
+}
+
+static cairo_surface_t* lookup_icon(TileGrid *grid, GtkWidget *widget, const gchar *icon_name) {
+    cairo_surface_t *surface;
+    GHashTable *icons;
+    GtkIconTheme *icon_theme;
+    gint scale;
+
+    if (!icon_name)
+        icon_name = "application-x-executable";
+
+    /* Decoded icons are shared by the overlays rendering at the same scale and size */
+    scale = gtk_widget_get_scale_factor(widget);
+    icons = overlay_get_icon_tier(grid->launcher, scale, grid->launcher->layout.icon_size);
+
+    surface = g_hash_table_lookup(icons, icon_name);
+    if (surface)
+        return surface;
+
+    icon_theme = gtk_icon_theme_get_for_screen(gtk_widget_get_screen(widget));
+
+    surface = gtk_icon_theme_load_surface(icon_theme, icon_name, grid->launcher->layout.icon_size, scale,
+                                          gtk_widget_get_window(widget),
+                                          GTK_ICON_LOOKUP_FORCE_SIZE, NULL);
+    if (!surface) {
+        surface = gtk_icon_theme_load_surface(icon_theme, "application-x-executable",
+                                              grid->launcher->layout.icon_size, scale,
+                                              gtk_widget_get_window(widget),
+                                              GTK_ICON_LOOKUP_FORCE_SIZE, NULL);
+    }
+
+    if (surface)
+        catalog_insert_icon(GINT_TO_POINTER(scale << 16 | grid->launcher->layout.icon_size), icon_name, surface);
+
+    return surface;
+}
+
+static PangoLayout* create_label_layout(TileGrid *grid, GtkWidget *widget, const gchar *text) {
+    PangoLayout *layout = gtk_widget_create_pango_layout(widget, text);
+
+    pango_layout_set_font_description(layout, grid->label_font);
+
+    /* Same constraints as the GtkLabel of the widget grid: two lines, ellipsized */
+    pango_layout_set_width(layout, (grid->launcher->layout.button_size - 2 * TILE_PADDING) * PANGO_SCALE);
+    pango_layout_set_height(layout, -2);
+    pango_layout_set_wrap(layout, PANGO_WRAP_WORD_CHAR);
+    pango_layout_set_ellipsize(layout, PANGO_ELLIPSIZE_END);
+    pango_layout_set_alignment(layout, PANGO_ALIGN_CENTER);
+
+    return layout;
+}
+
+/* Get the shaped label for a name, shaping it only on first use.
+ * Returns NULL once a deferrable frame used up its shaping budget. */
+static PangoLayout* get_label_layout(TileGrid *grid, GtkWidget *widget, const gchar *text,
+                                     gboolean deferrable, gint64 *shape_time) {
+    PangoLayout *layout = g_hash_table_lookup(grid->layouts, text);
+    gint64 start;
+
+    if (layout)
+        return layout;
+
+    if (deferrable && *shape_time >= LABEL_SHAPE_BUDGET_US)
+        return NULL;
+
+    start = g_get_monotonic_time();
+    layout = create_label_layout(grid, widget, text);
+    /* Shape and ellipsize now, the cached layout keeps the result */
+    pango_layout_get_extents(layout, NULL, NULL);
+    *shape_time += g_get_monotonic_time() - start;
+
+    if (g_hash_table_size(grid->layouts) >= LAYOUT_CACHE_SIZE)
+        g_hash_table_remove_all(grid->layouts);
+    g_hash_table_insert(grid->layouts, g_strdup(text), layout);
+
+    return layout;
+}
+
+static void clear_label_layouts(TileGrid *grid) {
+    g_hash_table_remove_all(grid->layouts);
+}
+
+static void draw_tile(TileGrid *grid, GtkWidget *widget, cairo_t *cr,
+                      const GridItem *item, gint index, gboolean live, gint64 *shape_time) {
+    GtkStyleContext *context = item->folder_info ? grid->folder_context : grid->app_context;
+    const GridLayout *grid_layout = &grid->launcher->layout;
+    GtkStateFlags state = GTK_STATE_FLAG_NORMAL;
+    cairo_surface_t *surface;
+    PangoLayout *layout;
+    GdkRectangle rect;
+
+    get_tile_rect(grid, index, &rect);
+
+    /* Snapshots are taken without pointer or focus feedback */
+    if (live) {
+        if (index == grid->hover_index)
+            state |= GTK_STATE_FLAG_PRELIGHT;
+        if (index == grid->press_index && index == grid->hover_index)
+            state |= GTK_STATE_FLAG_ACTIVE;
+        if (index == grid->focus_index)
+            state |= GTK_STATE_FLAG_SELECTED;
+    }
+
+    gtk_style_context_set_state(context, state);
+    gtk_render_background(context, cr, rect.x, rect.y, rect.width, rect.height);
+    gtk_render_frame(context, cr, rect.x, rect.y, rect.width, rect.height);
+
+    surface = lookup_icon(grid, widget,
+                          item->folder_info ? item->folder_info->icon : item->app_info->icon);
+    if (surface) {
+        gtk_render_icon_surface(context, cr, surface,
+                                rect.x + (grid_layout->button_size - grid_layout->icon_size) / 2,
+                                rect.y + TILE_PADDING);
+    }
+
+    /* Snapshots need every label, live frames stay within the budget */
+    layout = get_label_layout(grid, widget, get_item_name(item), live, shape_time);
+    if (!layout) {
+        grid->labels_deferred = TRUE;
+        return;
+    }
+
+    gtk_style_context_set_state(grid->label_context, state);
+    gtk_render_layout(grid->label_context, cr,
+                      rect.x + TILE_PADDING,
+                      rect.y + TILE_PADDING + grid_layout->icon_size + LABEL_SPACING,
+                      layout);
+}
+
+/* Render a page into an offscreen surface, transitions only move these around */
+static cairo_surface_t* render_page_surface(TileGrid *grid, GtkWidget *widget,
+                                            const GridItem *items, gint count) {
+    gint scale = gtk_widget_get_scale_factor(widget);
+    gint64 shape_time = 0;
+    cairo_surface_t *surface;
+    cairo_t *cr;
+    gint i;
+
+    /* Image surfaces keep compositing on the CPU path cheap, no readback from the server */
+    surface = gdk_window_create_similar_image_surface(gtk_widget_get_window(widget), CAIRO_FORMAT_ARGB32,
+                                                      gtk_widget_get_allocated_width(widget) * scale,
+                                                      gtk_widget_get_allocated_height(widget) * scale,
+                                                      scale);
+    cr = cairo_create(surface);
+    for (i = 0; i < count; i++)
+        draw_tile(grid, widget, cr, &items[i], i, FALSE, &shape_time);
+    cairo_destroy(cr);
+
+    perf_counter_add(&grid->launcher->label_shape_time, shape_time);
+    return surface;
+}
+
+static void draw_transition(TileGrid *grid, GtkWidget *widget, cairo_t *cr) {
+    gint width = gtk_widget_get_allocated_width(widget);
+    gint offset;
+
+    if (!grid->in_surface && grid->render_incoming) {
+        grid->in_surface = render_page_surface(grid, widget, (GridItem *)grid->items->data, grid->items->len);
+        grid->render_incoming = FALSE;
+    }
+
+    /* Swipes always slide, the pages follow the finger */
+    if (grid->launcher->page_transition == PAGE_TRANSITION_FADE && grid->target_page < 0) {
+        cairo_set_source_surface(cr, grid->out_surface, 0, 0);
+        cairo_paint_with_alpha(cr, 1.0 - grid->progress);
+        if (grid->in_surface) {
+            cairo_set_source_surface(cr, grid->in_surface, 0, 0);
+            cairo_paint_with_alpha(cr, grid->progress);
+        }
+        return;
+    }
+
+    /* Whole pixel offsets keep the blit unfiltered */
+    offset = (gint)round(grid->progress * width);
+    cairo_set_source_surface(cr, grid->out_surface, -grid->direction * offset, 0);
+    cairo_paint(cr);
+    if (grid->in_surface) {
+        cairo_set_source_surface(cr, grid->in_surface, grid->direction * (width - offset), 0);
+        cairo_paint(cr);
+    }
+}
+
+static gboolean on_tile_grid_draw(GtkWidget *widget, cairo_t *cr, TileGrid *grid) {
+    GdkRectangle clip, rect;
+    gint64 start = g_get_monotonic_time();
+    gint64 shape_time = 0;
+    guint i;
+
+    if (!gdk_cairo_get_clip_rectangle(cr, &clip))
+        return FALSE;
+
+    ensure_style_contexts(grid, widget);
+
+    if (grid->out_surface) {
+        draw_transition(grid, widget, cr);
+        perf_counter_add(&grid->launcher->tile_draw_time, g_get_monotonic_time() - start);
+        return FALSE;
+    }
+
+    grid->labels_deferred = FALSE;
+    for (i = 0; i < grid->items->len; i++) {
+        get_tile_rect(grid, i, &rect);
+        if (gdk_rectangle_intersect(&rect, &clip, NULL))
+            draw_tile(grid, widget, cr, &g_array_index(grid->items, GridItem, i), i, TRUE, &shape_time);
+    }
+
+    /* Labels over budget are shaped in the next frame, input is handled in between */
+    if (grid->labels_deferred)
+        gtk_widget_queue_draw(widget);
+
+    perf_counter_add(&grid->launcher->tile_draw_time, g_get_monotonic_time() - start);
+    perf_counter_add(&grid->launcher->label_shape_time, shape_time);
+
+    return FALSE;
+}
+
+static void stop_transition(TileGrid *grid, GtkWidget *widget) {
+    if (grid->tick_id) {
+        gtk_widget_remove_tick_callback(widget, grid->tick_id);
+        grid->tick_id = 0;
+    }
+    g_clear_pointer(&grid->out_surface, cairo_surface_destroy);
+    g_clear_pointer(&grid->in_surface, cairo_surface_destroy);
+    grid->render_incoming = FALSE;
+    grid->tracking = FALSE;
+    grid->progress = 0.0;
+    gtk_widget_queue_draw(widget);
+}
+
+static gboolean on_transition_tick(GtkWidget *widget, GdkFrameClock *clock, gpointer data) {
+    TileGrid *grid = get_tile_grid(widget);
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+    gdouble t;
+
+    /* Time starts at the first frame, not when the flip was requested */
+    if (grid->start_time == 0)
+        grid->start_time = now;
+
+    t = CLAMP((gdouble)(now - grid->start_time) / grid->duration, 0.0, 1.0);
+    grid->progress = grid->from_progress + (grid->to_progress - grid->from_progress) * (1.0 - pow(1.0 - t, 3));
+    gtk_widget_queue_draw(widget);
+
+    if (t < 1.0)
+        return G_SOURCE_CONTINUE;
+
+    /* Back to live drawing of the current items */
+    grid->tick_id = 0;
+    stop_transition(grid, widget);
+    return G_SOURCE_REMOVE;
+}
+
+static void start_animation(TileGrid *grid, GtkWidget *widget, gdouble to, gint64 duration) {
+    grid->from_progress = grid->progress;
+    grid->to_progress = to;
+    grid->start_time = 0;
+    grid->duration = duration;
+
+    if (!grid->tick_id)
+        grid->tick_id = gtk_widget_add_tick_callback(widget, on_transition_tick, NULL, NULL);
+}
+
+static void on_tile_grid_unmap(GtkWidget *widget, TileGrid *grid) {
+    stop_transition(grid, widget);
+}
+
+static void set_hover(TileGrid *grid, GtkWidget *widget, gint index) {
+    if (index == grid->hover_index)
+        return;
+
+    invalidate_tile(widget, grid->hover_index);
+    grid->hover_index = index;
+    invalidate_tile(widget, grid->hover_index);
+}
+
+static void set_focus(TileGrid *grid, GtkWidget *widget, gint index) {
+    gint old_index = grid->focus_index;
+
+    if (index == old_index)
+        return;
+
+    invalidate_tile(widget, old_index);
+    grid->focus_index = index;
+    invalidate_tile(widget, index);
+
+    tile_grid_accessible_selection_changed(widget, old_index, index);
+}
+
+static void activate_tile(TileGrid *grid, GtkWidget *widget, gint index) {
+    /* Copy the item, activating it may replace the page contents */
+    GridItem item = g_array_index(grid->items, GridItem, index);
+
+    if (item.app_info) {
+        launch_application(widget, item.app_info);
+    } else if (item.folder_info) {
+        on_folder_clicked(widget, item.folder_info);
+    }
+}
+
+/* Keyboard focus entering the grid lands on the highlighted tile */
+static gboolean on_tile_grid_focus_in(GtkWidget *widget, GdkEventFocus *event, TileGrid *grid) {
+    tile_grid_accessible_selection_changed(widget, -1, grid->focus_index);
+    return FALSE;
+}
+
+static gboolean on_tile_grid_motion(GtkWidget *widget, GdkEventMotion *event, TileGrid *grid) {
+    set_hover(grid, widget, get_tile_at(grid, event->x, event->y));
+    return FALSE;
+}
+
+static gboolean on_tile_grid_leave(GtkWidget *widget, GdkEventCrossing *event, TileGrid *grid) {
+    set_hover(grid, widget, -1);
+    return FALSE;
+}
+
+static gboolean on_tile_grid_button_press(GtkWidget *widget, GdkEventButton *event, TileGrid *grid) {
+    gint index = get_tile_at(grid, event->x, event->y);
+    GridItem *item;
+
+    if (event->type != GDK_BUTTON_PRESS || index < 0)
+        return FALSE;
+
+    item = &g_array_index(grid->items, GridItem, index);
+
+    if (event->button == 3 && item->app_info) {
+        return on_button_press_event(widget, event, item->app_info);
+    }
+    if (event->button == 3 && item->folder_info) {
+        return on_folder_button_press_event(widget, event, item->folder_info);
+    }
+
+    if (event->button == 1) {
+        gtk_widget_grab_focus(widget);
+        grid->press_index = index;
+        selection_set(grid->launcher,
+                      page_index_get_page_start(grid->launcher, grid->launcher->current_page) + index);
+        invalidate_tile(widget, index);
+    }
+
+    /* Let the drag source see the press as well */
+    return FALSE;
+}
+
+static gboolean on_tile_grid_button_release(GtkWidget *widget, GdkEventButton *event, TileGrid *grid) {
+    gint index = get_tile_at(grid, event->x, event->y);
+    gint pressed = grid->press_index;
+
+    if (event->button != 1)
+        return FALSE;
+
+    grid->press_index = -1;
+    invalidate_tile(widget, pressed);
+
+    if (index >= 0 && index == pressed)
+        activate_tile(grid, widget, index);
+
+    return FALSE;
+}
+
+static gboolean on_tile_grid_query_tooltip(GtkWidget *widget, gint x, gint y, gboolean keyboard_mode,
+                                           GtkTooltip *tooltip, TileGrid *grid) {
+    gint index = keyboard_mode ? grid->focus_index : get_tile_at(grid, x, y);
+    GdkRectangle rect;
+
+    if (index < 0 || index >= (gint)grid->items->len)
+        return FALSE;
+
+    get_tile_rect(grid, index, &rect);
+    gtk_tooltip_set_text(tooltip, get_item_name(&g_array_index(grid->items, GridItem, index)));
+    gtk_tooltip_set_tip_area(tooltip, &rect);
+    return TRUE;
+}
+
+static void on_tile_grid_drag_begin(GtkWidget *widget, GdkDragContext *context, TileGrid *grid) {
+    GridItem *item;
+    cairo_surface_t *surface;
+
+    if (grid->press_index < 0 || grid->press_index >= (gint)grid->items->len)
+        return;
+
+    item = &g_array_index(grid->items, GridItem, grid->press_index);
+    if (!item->app_info)
+        return;
+
+    grid->launcher->drag_source = item->app_info;
+
+    surface = lookup_icon(grid, widget, item->app_info->icon);
+    if (surface)
+        gtk_drag_set_icon_surface(context, surface);
+}
+
+static void on_tile_grid_drag_end(GtkWidget *widget, GdkDragContext *context, TileGrid *grid) {
+    invalidate_tile(widget, grid->press_index);
+    grid->press_index = -1;
+}
+
+static void on_tile_grid_drag_data_get(GtkWidget *widget, GdkDragContext *context,
+                                       GtkSelectionData *data, guint info, guint time,
+                                       TileGrid *grid) {
+    on_drag_data_get(widget, context, data, info, time, grid->launcher->drag_source);
+}
+
+static void on_icon_theme_changed(GtkIconTheme *icon_theme, GtkWidget *widget) {
+    catalog_clear_icons();
+    gtk_widget_queue_draw(widget);
+}
+
+/* Icons come from the tier of the new scale, only the labels need reshaping */
+static void on_scale_factor_changed(GtkWidget *widget, GParamSpec *pspec, TileGrid *grid) {
+    clear_label_layouts(grid);
+    gtk_widget_queue_draw(widget);
+}
+
+static void on_tile_grid_style_updated(GtkWidget *widget, TileGrid *grid) {
+    if (grid->label_context) {
+        sync_label_font(grid);
+        gtk_widget_queue_draw(widget);
+    }
+}
+
+/* Font or DPI changed: layouts hold glyphs shaped for the old metrics */
+static void on_font_settings_changed(GtkSettings *settings, GParamSpec *pspec, GtkWidget *widget) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    clear_label_layouts(grid);
+    if (grid->label_context)
+        sync_label_font(grid);
+    gtk_widget_queue_draw(widget);
+}
+
+/* A drawing area whose accessible has a child per tile, see tile-grid-accessible.c */
+typedef GtkDrawingArea TileGridArea;
+typedef GtkDrawingAreaClass TileGridAreaClass;
+
+G_DEFINE_TYPE(TileGridArea, tile_grid_area, GTK_TYPE_DRAWING_AREA)
+
+static void tile_grid_area_class_init(TileGridAreaClass *klass) {
+    gtk_widget_class_set_accessible_type(GTK_WIDGET_CLASS(klass), tile_grid_accessible_get_type());
+}
+
+static void tile_grid_area_init(TileGridArea *area) {
+}
+
+GtkWidget* tile_grid_new(LauncherPlugin *launcher) {
+    GtkWidget *widget = g_object_new(tile_grid_area_get_type(), NULL);
+    TileGrid *grid = g_new0(TileGrid, 1);
+
+    grid->launcher = launcher;
+    grid->items = g_array_new(FALSE, FALSE, sizeof(GridItem));
+    grid->hover_index = -1;
+    grid->focus_index = -1;
+    grid->press_index = -1;
+    grid->layouts = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+
+    g_object_set_data_full(G_OBJECT(widget), "tile-grid", grid, (GDestroyNotify)tile_grid_free);
+    g_object_set_data(G_OBJECT(widget), "launcher", launcher);
+
+    tile_grid_layout_changed(widget);
+    gtk_widget_set_can_focus(widget, TRUE);
+    gtk_widget_set_has_tooltip(widget, TRUE);
+    gtk_widget_add_events(widget,
+                          GDK_POINTER_MOTION_MASK |
+                          GDK_LEAVE_NOTIFY_MASK |
+                          GDK_BUTTON_PRESS_MASK |
+                          GDK_BUTTON_RELEASE_MASK);
+
+    g_signal_connect(widget, "draw", G_CALLBACK(on_tile_grid_draw), grid);
+    g_signal_connect(widget, "focus-in-event", G_CALLBACK(on_tile_grid_focus_in), grid);
+    g_signal_connect(widget, "motion-notify-event", G_CALLBACK(on_tile_grid_motion), grid);
+    g_signal_connect(widget, "leave-notify-event", G_CALLBACK(on_tile_grid_leave), grid);
+    g_signal_connect(widget, "button-press-event", G_CALLBACK(on_tile_grid_button_press), grid);
+    g_signal_connect(widget, "button-release-event", G_CALLBACK(on_tile_grid_button_release), grid);
+    g_signal_connect(widget, "query-tooltip", G_CALLBACK(on_tile_grid_query_tooltip), grid);
+    g_signal_connect(widget, "notify::scale-factor", G_CALLBACK(on_scale_factor_changed), grid);
+    g_signal_connect(widget, "style-updated", G_CALLBACK(on_tile_grid_style_updated), grid);
+    g_signal_connect(widget, "unmap", G_CALLBACK(on_tile_grid_unmap), grid);
+
+    /* Drag source for reordering and folder creation */
+    gtk_drag_source_set(widget, GDK_BUTTON1_MASK, NULL, 0, GDK_ACTION_MOVE);
+    g_signal_connect(widget, "drag-begin", G_CALLBACK(on_tile_grid_drag_begin), grid);
+    g_signal_connect(widget, "drag-end", G_CALLBACK(on_tile_grid_drag_end), grid);
+    g_signal_connect(widget, "drag-data-get", G_CALLBACK(on_tile_grid_drag_data_get), grid);
+
+    g_signal_connect_object(gtk_icon_theme_get_default(), "changed",
+                            G_CALLBACK(on_icon_theme_changed), widget, 0);
+    g_signal_connect_object(gtk_settings_get_default(), "notify::gtk-font-name",
+                            G_CALLBACK(on_font_settings_changed), widget, 0);
+    g_signal_connect_object(gtk_settings_get_default(), "notify::gtk-xft-dpi",
+                            G_CALLBACK(on_font_settings_changed), widget, 0);
+
+    return widget;
+}
+
+/* Replace the tiles shown by the grid */
+void tile_grid_set_items(GtkWidget *widget, const GridItem *items, gint count) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    g_array_set_size(grid->items, 0);
+    g_array_append_vals(grid->items, items, count);
+
+    grid->hover_index = -1;
+    grid->press_index = -1;
+    /* The launcher puts the selection back once the page is set */
+    grid->focus_index = -1;
+
+    /* A running transition shows the new items, a committed swipe already rendered them */
+    if (grid->out_surface && grid->target_page != grid->launcher->current_page) {
+        g_clear_pointer(&grid->in_surface, cairo_surface_destroy);
+        grid->render_incoming = TRUE;
+    }
+
+    tile_grid_accessible_items_changed(widget, count);
+    gtk_widget_queue_draw(widget);
+}
+
+/* Replace count items from first on, e.g. after a move; only their tiles are redrawn */
+void tile_grid_update_items(GtkWidget *widget, gint first, const GridItem *items, gint count) {
+    TileGrid *grid = get_tile_grid(widget);
+    gint i;
+
+    if (first < 0 || first + count > (gint)grid->items->len)
+        return;
+
+    for (i = 0; i < count; i++) {
+        g_array_index(grid->items, GridItem, first + i) = items[i];
+        invalidate_tile(widget, first + i);
+    }
+    tile_grid_accessible_names_changed(widget, first, count);
+}
+
+/* Highlight one tile, -1 for none; only the two tiles involved are redrawn */
+void tile_grid_set_selection(GtkWidget *widget, gint index) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    if (index >= (gint)grid->items->len)
+        index = -1;
+    set_focus(grid, widget, index);
+}
+
+/* Tiles as the accessible sees them, index is page-local */
+gint tile_grid_get_item_count(GtkWidget *widget) {
+    return get_tile_grid(widget)->items->len;
+}
+
+const gchar* tile_grid_get_item_name(GtkWidget *widget, gint index) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    if (index < 0 || index >= (gint)grid->items->len)
+        return NULL;
+    return get_item_name(&g_array_index(grid->items, GridItem, index));
+}
+
+void tile_grid_get_tile_rect(GtkWidget *widget, gint index, GdkRectangle *rect) {
+    get_tile_rect(get_tile_grid(widget), index, rect);
+}
+
+gint tile_grid_get_selection(GtkWidget *widget) {
+    return get_tile_grid(widget)->focus_index;
+}
+
+/* Select a tile and give the grid the keyboard focus */
+void tile_grid_focus_tile(GtkWidget *widget, gint index) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    if (index < 0 || index >= (gint)grid->items->len)
+        return;
+
+    gtk_widget_grab_focus(widget);
+    selection_set(grid->launcher,
+                  page_index_get_page_start(grid->launcher, grid->launcher->current_page) + index);
+}
+
+/* Launch the app or open the folder of a tile, as a click does */
+void tile_grid_activate(GtkWidget *widget, gint index) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    if (index >= 0 && index < (gint)grid->items->len)
+        activate_tile(grid, widget, index);
+}
+
+/* Find the tile at widget coordinates, used for drop targets */
+gboolean tile_grid_hit_test(GtkWidget *widget, gint x, gint y, GridItem *item) {
+    TileGrid *grid = get_tile_grid(widget);
+    gint index = get_tile_at(grid, x, y);
+
+    if (index < 0)
+        return FALSE;
+
+    *item = g_array_index(grid->items, GridItem, index);
+    return TRUE;
+}
+
+/* Decode an icon ahead of drawing, used by the warm-up */
+void tile_grid_preload_icon(GtkWidget *widget, const gchar *icon_name) {
+    lookup_icon(get_tile_grid(widget), widget, icon_name);
+}
+
+/* Animate from the page on screen to the items set next, direction 1 is the next page */
+void tile_grid_begin_transition(GtkWidget *widget, gint direction) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    if (grid->launcher->page_transition == PAGE_TRANSITION_NONE || !gtk_widget_get_mapped(widget))
+        return;
+
+    ensure_style_contexts(grid, widget);
+
+    /* A flip during a running one starts from the page it was heading to */
+    stop_transition(grid, widget);
+    grid->out_surface = render_page_surface(grid, widget, (GridItem *)grid->items->data, grid->items->len);
+    grid->direction = direction;
+    grid->target_page = -1;
+    grid->render_incoming = TRUE;
+    start_animation(grid, widget, 1.0, TRANSITION_DURATION_US);
+}
+
+/* Move the pages with the finger, offset is the horizontal travel in pixels */
+void tile_grid_swipe_update(GtkWidget *widget, gdouble offset) {
+    TileGrid *grid = get_tile_grid(widget);
+    LauncherPlugin *launcher = grid->launcher;
+    gint width = gtk_widget_get_allocated_width(widget);
+    gint direction = offset < 0 ? 1 : -1;
+    gint target = launcher->current_page + direction;
+    GridItem *items;
+    gint count;
+
+    if (width <= 0 || !gtk_widget_get_mapped(widget))
+        return;
+
+    ensure_style_contexts(grid, widget);
+
+    if (!grid->tracking) {
+        stop_transition(grid, widget);
+        grid->out_surface = render_page_surface(grid, widget, (GridItem *)grid->items->data, grid->items->len);
+        grid->tracking = TRUE;
+        grid->direction = 0;
+    }
+
+    /* The neighbour is rendered once per direction, not per motion event */
+    if (direction != grid->direction) {
+        g_clear_pointer(&grid->in_surface, cairo_surface_destroy);
+        grid->direction = direction;
+        grid->target_page = target;
+        if (target >= 0 && target < page_index_get_page_count(launcher)) {
+            items = page_index_get_page(launcher, target, &count);
+            grid->in_surface = render_page_surface(grid, widget, items, count);
+        }
+    }
+
+    /* Past the first or last page the content resists the finger */
+    if (!grid->in_surface)
+        offset /= 3.0;
+
+    grid->progress = CLAMP(fabs(offset) / width, 0.0, 1.0);
+    gtk_widget_queue_draw(widget);
+}
+
+/* Animate a released swipe to progress to, 1.0 shows the revealed page */
+static void settle_swipe(TileGrid *grid, GtkWidget *widget, gdouble to, gdouble velocity) {
+    gint width = gtk_widget_get_allocated_width(widget);
+    gdouble speed;
+
+    grid->tracking = FALSE;
+
+    /* The ease-out starts at three times its average speed, matching the finger */
+    speed = MAX(fabs(velocity), SWIPE_FLICK_VELOCITY);
+    start_animation(grid, widget, to,
+                    CLAMP((gint64)(3.0 * fabs(to - grid->progress) * width / speed * G_USEC_PER_SEC),
+                          SETTLE_MIN_US, SETTLE_MAX_US));
+}
+
+/* Settle a tracked swipe, returns the page step the caller has to commit */
+gint tile_grid_swipe_end(GtkWidget *widget, gdouble velocity) {
+    TileGrid *grid = get_tile_grid(widget);
+    gdouble towards;
+    gint step = 0;
+
+    if (!grid->tracking)
+        return 0;
+
+    /* Speed in the direction of the revealed page, a flick back cancels */
+    towards = -velocity * grid->direction;
+    if (grid->in_surface &&
+        (towards > SWIPE_FLICK_VELOCITY || (grid->progress > 0.5 && towards > -SWIPE_FLICK_VELOCITY)))
+        step = grid->direction;
+
+    settle_swipe(grid, widget, step != 0 ? 1.0 : 0.0, velocity);
+    return step;
+}
+
+/* The gesture was taken away mid-swipe, slide back to the page shown */
+void tile_grid_swipe_cancel(GtkWidget *widget) {
+    TileGrid *grid = get_tile_grid(widget);
+
+    if (grid->tracking)
+        settle_swipe(grid, widget, 0.0, 0.0);
+}
+
+/* Tile or grid size changed: labels were shaped for the old tile width */
+void tile_grid_layout_changed(GtkWidget *widget) {
+    TileGrid *grid = get_tile_grid(widget);
+    const GridLayout *layout = &grid->launcher->layout;
+
+    stop_transition(grid, widget);
+    clear_label_layouts(grid);
+
+    gtk_widget_set_size_request(widget,
+                                layout->columns * layout->pitch - TILE_SPACING,
+                                layout->rows * layout->pitch - TILE_SPACING);
+}
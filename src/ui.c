@@ -7,32 +7,30 @@
  */
 
 #include "xfce-launcher.h"
+#include <string.h>
+
+/* Time spent building tiles per slice, the rest of the frame is left to input and drawing */
+#define BUILD_BUDGET_US 4000
 
 void create_overlay_window(LauncherPlugin *launcher) {
     GtkWidget *main_box, *search_box, *grid_container, *center_box;
     GdkScreen *screen;
     GdkVisual *visual;
+    GtkGesture *swipe_gesture;
     
     launcher->overlay_window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
     gtk_window_set_type_hint(GTK_WINDOW(launcher->overlay_window), GDK_WINDOW_TYPE_HINT_DIALOG);
     gtk_window_set_decorated(GTK_WINDOW(launcher->overlay_window), FALSE);
     gtk_window_set_skip_taskbar_hint(GTK_WINDOW(launcher->overlay_window), TRUE);
     gtk_window_set_skip_pager_hint(GTK_WINDOW(launcher->overlay_window), TRUE);
-    gtk_window_fullscreen(GTK_WINDOW(launcher->overlay_window));
+    overlay_fullscreen(launcher);
+    g_object_set_data(G_OBJECT(launcher->overlay_window), "launcher", launcher);
     
     screen = gtk_widget_get_screen(launcher->overlay_window);
     visual = gdk_screen_get_rgba_visual(screen);
     if (visual && gdk_screen_is_composited(screen)) {
         gtk_widget_set_visual(launcher->overlay_window, visual);
     }
-    
-    GtkCssProvider *provider = gtk_css_provider_new();
-    gtk_css_provider_load_from_data(provider, get_css_style(), -1, NULL);
-
-    GtkStyleContext *context = gtk_widget_get_style_context(launcher->overlay_window);
-    gtk_style_context_add_provider(context,
-                                   GTK_STYLE_PROVIDER(provider),
-                                   GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 
     main_box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
     gtk_container_add(GTK_CONTAINER(launcher->overlay_window), main_box);
@@ -65,12 +63,9 @@ void create_overlay_window(LauncherPlugin *launcher) {
     grid_container = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
     gtk_box_pack_start(GTK_BOX(center_box), grid_container, FALSE, FALSE, 0);
 
-    launcher->app_grid = gtk_grid_new();
-    gtk_grid_set_row_spacing(GTK_GRID(launcher->app_grid), 20);
-    gtk_grid_set_column_spacing(GTK_GRID(launcher->app_grid), 20);
-    gtk_widget_set_halign(launcher->app_grid, GTK_ALIGN_CENTER);
-    gtk_widget_set_valign(launcher->app_grid, GTK_ALIGN_CENTER);
-    gtk_box_pack_start(GTK_BOX(grid_container), launcher->app_grid, FALSE, FALSE, 0);
+    launcher->grid_container = grid_container;
+    layout_update(launcher, overlay_get_monitor(launcher));
+    create_app_grid(launcher);
 
     launcher->page_dots = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_widget_set_halign(launcher->page_dots, GTK_ALIGN_CENTER);
@@ -86,136 +81,506 @@ void create_overlay_window(LauncherPlugin *launcher) {
     g_signal_connect(launcher->overlay_window, "scroll-event",
                      G_CALLBACK(on_scroll_event), launcher);
 
-    gtk_style_context_add_provider_for_screen(screen,
-                                             GTK_STYLE_PROVIDER(provider),
-                                             GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+    /* Swipe gesture for touchpad, owned by the window */
+    swipe_gesture = gtk_gesture_swipe_new(launcher->overlay_window);
+    gtk_gesture_single_set_touch_only(GTK_GESTURE_SINGLE(swipe_gesture), FALSE);
+    g_signal_connect(swipe_gesture, "begin",
+                     G_CALLBACK(on_swipe_begin), launcher);
+    g_signal_connect(swipe_gesture, "update",
+                     G_CALLBACK(on_swipe_update), launcher);
+    g_signal_connect(swipe_gesture, "swipe",
+                     G_CALLBACK(on_swipe_gesture), launcher);
+    g_signal_connect(swipe_gesture, "cancel",
+                     G_CALLBACK(on_swipe_cancel), launcher);
+    g_object_set_data_full(G_OBJECT(launcher->overlay_window), "swipe-gesture",
+                           swipe_gesture, g_object_unref);
+
+    perf_watch_frames(launcher, launcher->overlay_window);
+
+    /* Styles are scoped to the overlay, the rest of the panel never sees them.
+     * Applied once the tree is built, tiles and dots made later style themselves */
+    theme_apply(launcher->overlay_window);
+
+    /* Everything but the window itself is shown once, opening only maps the window */
+    gtk_widget_show_all(main_box);
+    if (launcher->hot_standby)
+        gtk_widget_realize(launcher->overlay_window);
+}
 
-    g_object_unref(provider);
+/* Create the application grid, either as GtkGrid of buttons or as a single drawn widget */
+void create_app_grid(LauncherPlugin *launcher) {
+    page_build_cancel(launcher);
+    if (launcher->app_grid)
+        gtk_widget_destroy(launcher->app_grid);
+
+    if (launcher->drawn_grid) {
+        launcher->app_grid = tile_grid_new(launcher);
+    } else {
+        launcher->app_grid = gtk_grid_new();
+        gtk_grid_set_row_spacing(GTK_GRID(launcher->app_grid), 20);
+        gtk_grid_set_column_spacing(GTK_GRID(launcher->app_grid), 20);
+    }
+    gtk_widget_set_halign(launcher->app_grid, GTK_ALIGN_CENTER);
+    gtk_widget_set_valign(launcher->app_grid, GTK_ALIGN_CENTER);
+    gtk_box_pack_start(GTK_BOX(launcher->grid_container), launcher->app_grid, FALSE, FALSE, 0);
+    gtk_widget_show(launcher->app_grid);
+    theme_apply(launcher->app_grid);
+
+    /* Connect drag and drop signals on grid */
+    gtk_drag_dest_set(launcher->app_grid, GTK_DEST_DEFAULT_ALL, NULL, 0, GDK_ACTION_MOVE);
+    g_signal_connect(launcher->app_grid, "drag-drop",
+                     G_CALLBACK(on_drag_drop), launcher);
 }
 
 void hide_overlay(LauncherPlugin *launcher) {
     if (launcher->overlay_window) {
         gtk_widget_hide(launcher->overlay_window);
-        gtk_entry_set_text(GTK_ENTRY(launcher->search_entry), "");
 
-        if (launcher->filtered_list) {
-            g_list_free(launcher->filtered_list);
+        /* Hidden for a launch, measured from the click */
+        if (launcher->launch_time != 0) {
+            perf_counter_add(&launcher->launch_latency, g_get_monotonic_time() - launcher->launch_time);
+            launcher->launch_time = 0;
         }
-        launcher->filtered_list = g_list_copy(launcher->app_list);
+        perf_report_overlay(launcher);
+        selection_set(launcher, -1);
+
+        /* Clearing the search emits search-changed right away, which
+         * restores the full list; an unfiltered list is left untouched */
+        gtk_entry_set_text(GTK_ENTRY(launcher->search_entry), "");
         launcher->current_page = 0;
+
+        if (launcher->hot_standby)
+            schedule_standby_rebuild(launcher);
     }
 }
 
-void populate_current_page(LauncherPlugin *launcher) {
-    GList *iter;
-    gint row, col;
-    gint start_index = launcher->current_page * APPS_PER_PAGE;
-    gint grid_index = 0;
+static gboolean standby_rebuild(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
 
-    gtk_container_foreach(GTK_CONTAINER(launcher->app_grid),
-                         (GtkCallback)gtk_widget_destroy, NULL);
+    launcher->standby_source = 0;
+    if (launcher->page_dirty || launcher->shown_page != launcher->current_page) {
+        populate_current_page(launcher);
+        update_page_dots(launcher);
+    }
 
-    /* Display folders */
-    for (iter = launcher->folder_list; iter != NULL; iter = g_list_next(iter)) {
-        FolderInfo *folder_info = (FolderInfo *)iter->data;
+    return G_SOURCE_REMOVE;
+}
 
-        col = grid_index % GRID_COLUMNS;
-        row = grid_index / GRID_COLUMNS;
+/* Rebuild the first page while the overlay is hidden, so opening it is only a map */
+void schedule_standby_rebuild(LauncherPlugin *launcher) {
+    if (launcher->standby_source || !launcher->overlay_window ||
+        gtk_widget_get_visible(launcher->overlay_window))
+        return;
 
-        GtkWidget *button, *box, *icon, *label;
-        button = gtk_button_new();
-        gtk_style_context_add_class(gtk_widget_get_style_context(button), "folder");
-        gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
-        gtk_widget_set_size_request(button, BUTTON_SIZE, BUTTON_SIZE);
+    launcher->standby_source = g_idle_add_full(G_PRIORITY_LOW, standby_rebuild, launcher, NULL);
+}
 
-        box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-        gtk_container_add(GTK_CONTAINER(button), box);
+/* Mark the page index stale after the filter or folder membership changed */
+void invalidate_page_index(LauncherPlugin *launcher) {
+    /* Pending tiles may point at apps that are about to go away */
+    page_build_cancel(launcher);
+    overlay_invalidate_all(launcher);
+    launcher->page_index_valid = FALSE;
+    launcher->page_dirty = TRUE;
+    launcher->warmup_ready = FALSE;
+    launcher->selected_index = -1;
+}
 
-        icon = gtk_image_new_from_icon_name(folder_info->icon, GTK_ICON_SIZE_DIALOG);
-        gtk_image_set_pixel_size(GTK_IMAGE(icon), ICON_SIZE);
-        gtk_box_pack_start(GTK_BOX(box), icon, FALSE, FALSE, 0);
+/* Build the list of visible tiles and the table of page starts */
+static void rebuild_page_index(LauncherPlugin *launcher) {
+    GList *iter;
+    gboolean searching = launcher->search_entry &&
+                         gtk_entry_get_text_length(GTK_ENTRY(launcher->search_entry)) > 0;
+    gint per_page = MAX(launcher->layout.apps_per_page, 1);
+    gint count, start = 0;
+
+    if (!launcher->page_items) {
+        launcher->page_items = g_array_new(FALSE, FALSE, sizeof(GridItem));
+        launcher->page_starts = g_array_new(FALSE, FALSE, sizeof(gint));
+    }
+    g_array_set_size(launcher->page_items, 0);
+    g_array_set_size(launcher->page_starts, 0);
+    launcher->frequent_count = 0;
 
-        label = gtk_label_new(folder_info->name);
-        gtk_box_pack_start(GTK_BOX(box), label, FALSE, FALSE, 0);
+    /* The most used apps get a page of their own in front of the rest */
+    if (launcher->frequent_page && launcher->open_folder == NULL && !searching) {
+        GList *frequent = usage_get_frequent(launcher, per_page);
 
-        g_signal_connect(button, "clicked", G_CALLBACK(on_folder_clicked), folder_info);
-        gtk_grid_attach(GTK_GRID(launcher->app_grid), button, col, row, 1, 1);
-        g_object_set_data(G_OBJECT(button), "folder-info", folder_info);
-        g_object_set_data(G_OBJECT(button), "launcher", launcher);
-        gtk_widget_show_all(button);
-        grid_index++;
+        for (iter = frequent; iter != NULL; iter = g_list_next(iter)) {
+            GridItem item = { (AppInfo *)iter->data, NULL };
+            g_array_append_val(launcher->page_items, item);
+        }
+        launcher->frequent_count = launcher->page_items->len;
+        if (launcher->frequent_count > 0)
+            g_array_append_val(launcher->page_starts, start);
+        g_list_free(frequent);
+    }
+
+    /* Folders come first, but not inside an open folder or in search results */
+    if (launcher->open_folder == NULL && !searching) {
+        for (iter = launcher->folder_list; iter != NULL; iter = g_list_next(iter)) {
+            GridItem item = { NULL, (FolderInfo *)iter->data };
+            g_array_append_val(launcher->page_items, item);
+        }
     }
 
-    /* Display applications */
     GList *apps_to_display = launcher->open_folder ? launcher->open_folder->apps : launcher->filtered_list;
     for (iter = apps_to_display; iter != NULL; iter = g_list_next(iter)) {
         AppInfo *app_info = (AppInfo *)iter->data;
 
-        if (launcher->open_folder == NULL && (app_info->is_hidden || app_info->folder_id)) {
+        if (!app_info->name)
+            continue;
+        if (launcher->open_folder == NULL && (app_info->is_hidden || app_info->folder_id))
             continue;
-        }
 
-        if (grid_index >= start_index && (launcher->open_folder != NULL || grid_index < start_index + APPS_PER_PAGE)) {
-            GtkWidget *button, *box, *icon, *label;
-
-            col = grid_index % GRID_COLUMNS;
-            row = grid_index / GRID_COLUMNS;
-
-            button = gtk_button_new();
-            gtk_style_context_add_class(gtk_widget_get_style_context(button), "app-button");
-            gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
-            gtk_widget_set_size_request(button, BUTTON_SIZE, BUTTON_SIZE);
-
-            box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
-            gtk_container_add(GTK_CONTAINER(button), box);
-
-            if (app_info->icon) {
-                icon = gtk_image_new_from_icon_name(app_info->icon, GTK_ICON_SIZE_DIALOG);
-                gtk_image_set_pixel_size(GTK_IMAGE(icon), ICON_SIZE);
-            } else {
-                icon = gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
-                gtk_image_set_pixel_size(GTK_IMAGE(icon), ICON_SIZE);
-            }
-            gtk_box_pack_start(GTK_BOX(box), icon, FALSE, FALSE, 0);
-
-            if (app_info->name) {
-                label = gtk_label_new(app_info->name);
-            } else {
-                continue;
-            }
-            gtk_label_set_line_wrap(GTK_LABEL(label), TRUE);
-            gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
-            gtk_label_set_max_width_chars(GTK_LABEL(label), 15);
-            gtk_label_set_lines(GTK_LABEL(label), 2);
-            gtk_box_pack_start(GTK_BOX(box), label, FALSE, FALSE, 0);
-
-            gtk_drag_source_set(button, GDK_BUTTON1_MASK, NULL, 0, GDK_ACTION_MOVE);
-            gtk_drag_dest_set(button, GTK_DEST_DEFAULT_ALL, NULL, 0, GDK_ACTION_MOVE);
-            g_signal_connect(button, "drag-data-received",
-                            G_CALLBACK(on_drag_data_received), launcher);
-            g_signal_connect(button, "drag-data-get",
-                            G_CALLBACK(on_drag_data_get), app_info);
-
-            g_signal_connect(button, "drag-begin",
-                            G_CALLBACK(on_drag_begin), launcher);
-
-            g_signal_connect(button, "button-press-event",
-                            G_CALLBACK(on_button_press_event), app_info);
-
-            g_signal_connect(button, "clicked",
-                            G_CALLBACK(launch_application), app_info);
-
-            gtk_grid_attach(GTK_GRID(launcher->app_grid), button, col, row, 1, 1);
-
-            g_object_set_data(G_OBJECT(button), "app-info", app_info);
-            g_object_set_data(G_OBJECT(button), "launcher", launcher);
-
-            gtk_widget_show_all(button);
-        }
-        grid_index++;
+        GridItem item = { app_info, NULL };
+        g_array_append_val(launcher->page_items, item);
+    }
+
+    count = launcher->page_items->len;
+    for (start = launcher->frequent_count; start < count; start += per_page)
+        g_array_append_val(launcher->page_starts, start);
+
+    launcher->page_index_valid = TRUE;
+}
+
+/* Get the tiles of one page, valid until the index is invalidated */
+GridItem* page_index_get_page(LauncherPlugin *launcher, gint page, gint *count) {
+    gint start, end;
+
+    if (!launcher->page_index_valid)
+        rebuild_page_index(launcher);
+
+    if (page < 0 || page >= (gint)launcher->page_starts->len) {
+        *count = 0;
+        return NULL;
+    }
+
+    start = g_array_index(launcher->page_starts, gint, page);
+    end = page + 1 < (gint)launcher->page_starts->len ?
+          g_array_index(launcher->page_starts, gint, page + 1) :
+          (gint)launcher->page_items->len;
+
+    *count = end - start;
+    return &g_array_index(launcher->page_items, GridItem, start);
+}
+
+/* Number of pages the current filter needs */
+gint page_index_get_page_count(LauncherPlugin *launcher) {
+    if (!launcher->page_index_valid)
+        rebuild_page_index(launcher);
+
+    return launcher->page_starts->len;
+}
+
+/* Index of the first tile of a page, pages are not all the same length */
+gint page_index_get_page_start(LauncherPlugin *launcher, gint page) {
+    if (!launcher->page_index_valid)
+        rebuild_page_index(launcher);
+
+    if (page < 0 || page >= (gint)launcher->page_starts->len)
+        return 0;
+    return g_array_index(launcher->page_starts, gint, page);
+}
+
+/* Number of tiles on all pages together */
+gint page_index_get_item_count(LauncherPlugin *launcher) {
+    if (!launcher->page_index_valid)
+        rebuild_page_index(launcher);
+
+    return launcher->page_items->len;
+}
+
+/* Page showing the tile at index */
+gint page_index_find_page(LauncherPlugin *launcher, gint index) {
+    gint low = 0, high;
+
+    if (!launcher->page_index_valid)
+        rebuild_page_index(launcher);
+
+    high = (gint)launcher->page_starts->len - 1;
+    while (low < high) {
+        gint mid = (low + high + 1) / 2;
+
+        if (g_array_index(launcher->page_starts, gint, mid) <= index)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+
+    return MAX(low, 0);
+}
+
+/* Tile index of an app outside the "Frequent" page, -1 if it is not shown */
+gint page_index_find_item(LauncherPlugin *launcher, AppInfo *app_info) {
+    gint i;
+
+    if (!launcher->page_index_valid)
+        rebuild_page_index(launcher);
+
+    for (i = launcher->frequent_count; i < (gint)launcher->page_items->len; i++) {
+        if (g_array_index(launcher->page_items, GridItem, i).app_info == app_info)
+            return i;
+    }
+    return -1;
+}
+
+GridItem* page_index_get_item(LauncherPlugin *launcher, gint index) {
+    if (!launcher->page_index_valid)
+        rebuild_page_index(launcher);
+
+    if (index < 0 || index >= (gint)launcher->page_items->len)
+        return NULL;
+    return &g_array_index(launcher->page_items, GridItem, index);
+}
+
+/* Move a tile from one index to another after a reorder, pages keep their lengths */
+void page_index_move_item(LauncherPlugin *launcher, gint from, gint to) {
+    GridItem *items = (GridItem *)launcher->page_items->data;
+    GridItem item = items[from];
+
+    if (from < to)
+        memmove(&items[from], &items[from + 1], (to - from) * sizeof(GridItem));
+    else
+        memmove(&items[to + 1], &items[to], (from - to) * sizeof(GridItem));
+    items[to] = item;
+
+    /* The overlays of other monitors build their page again when shown */
+    overlay_invalidate_all(launcher);
+    launcher->warmup_ready = FALSE;
+}
+
+void page_index_free(LauncherPlugin *launcher) {
+    page_build_cancel(launcher);
+    if (launcher->build_items) {
+        g_array_unref(launcher->build_items);
+        launcher->build_items = NULL;
+    }
+    if (launcher->page_items) {
+        g_array_unref(launcher->page_items);
+        g_array_unref(launcher->page_starts);
+        launcher->page_items = NULL;
+        launcher->page_starts = NULL;
+    }
+    launcher->page_index_valid = FALSE;
+}
+
+static GtkWidget* create_folder_tile(LauncherPlugin *launcher, FolderInfo *folder_info) {
+    GtkWidget *button, *box, *icon, *label;
+
+    button = gtk_button_new();
+    gtk_style_context_add_class(gtk_widget_get_style_context(button), "folder");
+    gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
+    gtk_widget_set_size_request(button, launcher->layout.button_size, launcher->layout.button_size);
+
+    box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_container_add(GTK_CONTAINER(button), box);
+
+    icon = gtk_image_new_from_icon_name(folder_info->icon, GTK_ICON_SIZE_DIALOG);
+    gtk_image_set_pixel_size(GTK_IMAGE(icon), launcher->layout.icon_size);
+    gtk_box_pack_start(GTK_BOX(box), icon, FALSE, FALSE, 0);
+
+    label = gtk_label_new(folder_info->name);
+    gtk_box_pack_start(GTK_BOX(box), label, FALSE, FALSE, 0);
+
+    g_signal_connect(button, "clicked", G_CALLBACK(on_folder_clicked), folder_info);
+    g_signal_connect(button, "button-press-event",
+                    G_CALLBACK(on_folder_button_press_event), folder_info);
+    g_object_set_data(G_OBJECT(button), "folder-info", folder_info);
+    g_object_set_data(G_OBJECT(button), "launcher", launcher);
+
+    return button;
+}
+
+static GtkWidget* create_app_tile(LauncherPlugin *launcher, AppInfo *app_info) {
+    GtkWidget *button, *box, *icon, *label;
+
+    button = gtk_button_new();
+    gtk_style_context_add_class(gtk_widget_get_style_context(button), "app-button");
+    gtk_button_set_relief(GTK_BUTTON(button), GTK_RELIEF_NONE);
+    gtk_widget_set_size_request(button, launcher->layout.button_size, launcher->layout.button_size);
+
+    box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
+    gtk_container_add(GTK_CONTAINER(button), box);
+
+    if (app_info->icon) {
+        icon = gtk_image_new_from_icon_name(app_info->icon, GTK_ICON_SIZE_DIALOG);
+        gtk_image_set_pixel_size(GTK_IMAGE(icon), launcher->layout.icon_size);
+    } else {
+        icon = gtk_image_new_from_icon_name("application-x-executable", GTK_ICON_SIZE_DIALOG);
+        gtk_image_set_pixel_size(GTK_IMAGE(icon), launcher->layout.icon_size);
+    }
+    gtk_box_pack_start(GTK_BOX(box), icon, FALSE, FALSE, 0);
+
+    label = gtk_label_new(app_info->name);
+    gtk_label_set_line_wrap(GTK_LABEL(label), TRUE);
+    gtk_label_set_ellipsize(GTK_LABEL(label), PANGO_ELLIPSIZE_END);
+    gtk_label_set_max_width_chars(GTK_LABEL(label), 15);
+    gtk_label_set_lines(GTK_LABEL(label), 2);
+    gtk_box_pack_start(GTK_BOX(box), label, FALSE, FALSE, 0);
+
+    gtk_drag_source_set(button, GDK_BUTTON1_MASK, NULL, 0, GDK_ACTION_MOVE);
+    gtk_drag_dest_set(button, GTK_DEST_DEFAULT_ALL, NULL, 0, GDK_ACTION_MOVE);
+    g_signal_connect(button, "drag-data-received",
+                    G_CALLBACK(on_drag_data_received), launcher);
+    g_signal_connect(button, "drag-data-get",
+                    G_CALLBACK(on_drag_data_get), app_info);
+
+    g_signal_connect(button, "drag-begin",
+                    G_CALLBACK(on_drag_begin), launcher);
+
+    g_signal_connect(button, "button-press-event",
+                    G_CALLBACK(on_button_press_event), app_info);
+
+    g_signal_connect(button, "clicked",
+                    G_CALLBACK(launch_application), app_info);
+
+    g_object_set_data(G_OBJECT(button), "app-info", app_info);
+    g_object_set_data(G_OBJECT(button), "launcher", launcher);
+
+    return button;
+}
+
+/* Add the tile of item at index i of the current page */
+static void attach_tile(LauncherPlugin *launcher, const GridItem *item, gint i) {
+    gint columns = launcher->layout.columns;
+    GtkWidget *tile;
+
+    if (item->folder_info)
+        tile = create_folder_tile(launcher, item->folder_info);
+    else
+        tile = create_app_tile(launcher, item->app_info);
+
+    gtk_grid_attach(GTK_GRID(launcher->app_grid), tile, i % columns, i / columns, 1, 1);
+    if (page_index_get_page_start(launcher, launcher->current_page) + i == launcher->selected_index)
+        gtk_widget_set_state_flags(tile, GTK_STATE_FLAG_SELECTED, FALSE);
+    theme_apply(tile);
+    gtk_widget_show_all(tile);
+}
+
+/* Build tiles of the pending page until the slice budget is used up, returns TRUE if some are left */
+static gboolean build_page_slice(LauncherPlugin *launcher) {
+    gint64 deadline = g_get_monotonic_time() + BUILD_BUDGET_US;
+
+    /* Reading order, the top rows are the ones looked at first */
+    while (launcher->build_next < (gint)launcher->build_items->len) {
+        gint i = launcher->build_next++;
+
+        attach_tile(launcher, &g_array_index(launcher->build_items, GridItem, i), i);
+
+        if (g_get_monotonic_time() >= deadline)
+            break;
+    }
+
+    return launcher->build_next < (gint)launcher->build_items->len;
+}
+
+static gboolean on_build_page_idle(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+
+    if (build_page_slice(launcher))
+        return G_SOURCE_CONTINUE;
+
+    launcher->build_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+/* Abandon the tiles still to be built, the page has to be built again */
+void page_build_cancel(LauncherPlugin *launcher) {
+    if (launcher->build_source) {
+        g_source_remove(launcher->build_source);
+        launcher->build_source = 0;
+        launcher->page_dirty = TRUE;
+    }
+}
+
+void populate_current_page(LauncherPlugin *launcher) {
+    GridItem *items;
+    gint count;
+    gint pages = page_index_get_page_count(launcher);
+
+    /* Hiding or moving apps may have removed the last page */
+    if (launcher->current_page >= pages)
+        launcher->current_page = MAX(pages - 1, 0);
+
+    items = page_index_get_page(launcher, launcher->current_page, &count);
+
+    if (launcher->drawn_grid) {
+        tile_grid_set_items(launcher->app_grid, items, count);
+        selection_show(launcher);
+        launcher->shown_page = launcher->current_page;
+        launcher->page_dirty = FALSE;
+        usage_prefetch_candidates(launcher);
+        return;
+    }
+
+    /* Work for a page or query that is no longer wanted is dropped */
+    page_build_cancel(launcher);
+
+    gtk_container_foreach(GTK_CONTAINER(launcher->app_grid),
+                         (GtkCallback)gtk_widget_destroy, NULL);
+
+    /* Copy the slice, the page index may be rebuilt before all tiles are */
+    if (!launcher->build_items)
+        launcher->build_items = g_array_new(FALSE, FALSE, sizeof(GridItem));
+    g_array_set_size(launcher->build_items, 0);
+    g_array_append_vals(launcher->build_items, items, count);
+    launcher->build_next = 0;
+
+    /* The first slice is built right away so a page never shows up empty */
+    if (build_page_slice(launcher))
+        launcher->build_source = g_idle_add(on_build_page_idle, launcher);
+
+    launcher->shown_page = launcher->current_page;
+    launcher->page_dirty = FALSE;
+    usage_prefetch_candidates(launcher);
+}
+
+/* Show the tiles between two indices again, only the ones on the current page are touched */
+void refresh_page_tiles(LauncherPlugin *launcher, gint first, gint last) {
+    gint start = page_index_get_page_start(launcher, launcher->current_page);
+    GridItem *items;
+    gint count, i;
+
+    items = page_index_get_page(launcher, launcher->current_page, &count);
+    first = MAX(first - start, 0);
+    last = MIN(last - start, count - 1);
+    if (first > last)
+        return;
+
+    if (launcher->drawn_grid) {
+        tile_grid_update_items(launcher->app_grid, first, items + first, last - first + 1);
+        return;
+    }
+
+    /* A page not fully built is built again */
+    if (launcher->build_source || launcher->page_dirty || launcher->shown_page != launcher->current_page) {
+        populate_current_page(launcher);
+        return;
+    }
+
+    for (i = first; i <= last; i++) {
+        GtkWidget *tile = gtk_grid_get_child_at(GTK_GRID(launcher->app_grid),
+                                                i % launcher->layout.columns, i / launcher->layout.columns);
+        if (tile)
+            gtk_widget_destroy(tile);
+        attach_tile(launcher, &items[i], i);
     }
 }
 
+/* Switch to another page, animated when the drawn grid is in use */
+void show_page(LauncherPlugin *launcher, gint page) {
+    if (page < 0 || page >= launcher->total_pages || page == launcher->current_page)
+        return;
+
+    if (launcher->drawn_grid)
+        tile_grid_begin_transition(launcher->app_grid, page > launcher->current_page ? 1 : -1);
+
+    launcher->current_page = page;
+    populate_current_page(launcher);
+    update_page_dots(launcher);
+}
+
 void update_page_dots(LauncherPlugin *launcher) {
     GList *children, *iter;
     gint i;
@@ -226,7 +591,7 @@ void update_page_dots(LauncherPlugin *launcher) {
     }
     g_list_free(children);
 
-    launcher->total_pages = (g_list_length(launcher->filtered_list) + APPS_PER_PAGE - 1) / APPS_PER_PAGE;
+    launcher->total_pages = page_index_get_page_count(launcher);
 
     for (i = 0; i < launcher->total_pages; i++) {
         GtkWidget *dot = gtk_button_new();
@@ -241,6 +606,7 @@ void update_page_dots(LauncherPlugin *launcher) {
         g_signal_connect(dot, "clicked", G_CALLBACK(on_dot_clicked), NULL);
 
         gtk_box_pack_start(GTK_BOX(launcher->page_dots), dot, FALSE, FALSE, 0);
+        theme_apply(dot);
         gtk_widget_show(dot);
     }
 }
@@ -267,6 +633,9 @@ const gchar* get_css_style(void) {
     "button.app-button:focus {\n"
     "  outline: none;\n"
     "}\n"
+    "button.app-button:selected {\n"
+    "  background-color: rgba(255, 255, 255, 0.15);\n"
+    "}\n"
     "button.app-button label {\n"
     "  color: rgba(255, 255, 255, 0.9);\n"
     "  font-size: 12px;\n"
@@ -328,6 +697,9 @@ const gchar* get_css_style(void) {
     "button.folder:hover {\n"
     "  background-color: rgba(255, 255, 255, 0.15);\n"
     "}\n"
+    "button.folder:selected {\n"
+    "  background-color: rgba(255, 255, 255, 0.2);\n"
+    "}\n"
     "button.folder label {\n"
     "  color: rgba(255, 255, 255, 0.9);\n"
     "  font-size: 12px;\n"
@@ -0,0 +1,539 @@
+/*
+ * Launch statistics and readahead for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#define _GNU_SOURCE
+#include "xfce-launcher.h"
+#include <errno.h>
+#include <glib/gstdio.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Launches are kept as frecency scores: every launch adds 1.0, and scores
+ * halve every FRECENCY_HALF_LIFE. On disk they live in an append-only log
+ * of (time, weight, desktop id) records. A launch appends one record; a
+ * compaction replaces the log with one record per app holding its decayed
+ * score. Both are written by a single background thread, in order. The
+ * scores and the writer are shared by every launcher of the process, like
+ * the catalog: a second writer would keep appending to the file a
+ * compaction of the first had replaced.
+ */
+
+#define FRECENCY_HALF_LIFE (14 * 24 * 3600.0)
+/* Scores below this are dropped when compacting */
+#define FRECENCY_MIN_SCORE 0.01
+/* Apps on the "Frequent" page need at least about one launch in the last two weeks */
+#define FREQUENT_MIN_SCORE 0.5
+
+#define LOG_MAGIC "XLFL"
+#define LOG_VERSION 1
+#define LOG_HEADER_SIZE 8
+/* time (gint64), weight (gdouble), id length (guint32), then the id */
+#define RECORD_HEADER_SIZE 20
+/* Compact once the log holds this many records more than there are apps */
+#define COMPACT_SLACK 1024
+
+/* Most launched apps on screen whose files are read ahead */
+#define PREFETCH_CANDIDATES 3
+/* Bytes read ahead per overlay opening, large IDEs stay within it */
+#define PREFETCH_BUDGET_BYTES (192 * 1024 * 1024)
+/* A file read ahead this recently is assumed to be cached still */
+#define PREFETCH_REPEAT_US (5 * 60 * G_USEC_PER_SEC)
+
+/* Decayed score of one app, valid at time */
+typedef struct {
+    gdouble score;
+    gint64  time;
+} Frecency;
+
+typedef enum {
+    LOG_APPEND,
+    LOG_REPLACE
+} LogJobType;
+
+/* Bytes to write to the log, prepared on the main thread */
+typedef struct {
+    LogJobType  type;
+    GByteArray  *data;
+} LogJob;
+
+/* State of the log writer thread */
+typedef struct {
+    gchar   *path;
+    gint    fd;
+} LogWriter;
+
+/* A file to read ahead; session groups the jobs of one overlay opening */
+typedef struct {
+    gchar *path;
+    guint session;
+} PrefetchJob;
+
+static guint usage_users = 0;
+static GHashTable *usage_frecency = NULL;
+static GThreadPool *usage_log_pool = NULL;
+static LogWriter *usage_writer = NULL;
+static guint usage_log_records = 0;
+
+static gchar* get_log_path(void) {
+    return g_build_filename(g_get_user_data_dir(), "xfce4", "launcher", "launches.log", NULL);
+}
+
+static gdouble decay(gdouble score, gint64 from, gint64 to) {
+    return score * exp2(-(gdouble)(to - from) / FRECENCY_HALF_LIFE);
+}
+
+static void add_score(LauncherPlugin *launcher, const gchar *id, gdouble weight, gint64 time) {
+    Frecency *entry = g_hash_table_lookup(launcher->frecency, id);
+
+    if (!entry) {
+        entry = g_new0(Frecency, 1);
+        entry->time = time;
+        g_hash_table_insert(launcher->frecency, g_strdup(id), entry);
+    }
+
+    /* Bring both to the later of the two times, the log is mostly in order */
+    if (time >= entry->time) {
+        entry->score = decay(entry->score, entry->time, time) + weight;
+        entry->time = time;
+    } else {
+        entry->score += decay(weight, time, entry->time);
+    }
+}
+
+static void append_record(GByteArray *data, const gchar *id, gdouble weight, gint64 time) {
+    guint8 header[RECORD_HEADER_SIZE];
+    guint32 id_len = strlen(id);
+
+    memcpy(header, &time, 8);
+    memcpy(header + 8, &weight, 8);
+    memcpy(header + 16, &id_len, 4);
+    g_byte_array_append(data, header, RECORD_HEADER_SIZE);
+    g_byte_array_append(data, (const guint8 *)id, id_len);
+}
+
+static GByteArray* new_log_data(void) {
+    GByteArray *data = g_byte_array_new();
+    guint32 version = LOG_VERSION;
+
+    g_byte_array_append(data, (const guint8 *)LOG_MAGIC, 4);
+    g_byte_array_append(data, (const guint8 *)&version, 4);
+    return data;
+}
+
+/* Runs on the writer thread, the only one touching the log file */
+static void write_log(gpointer data, gpointer user_data) {
+    LogJob *job = (LogJob *)data;
+    LogWriter *writer = (LogWriter *)user_data;
+    GError *error = NULL;
+    gchar *dir;
+
+    if (job->type == LOG_REPLACE) {
+        dir = g_path_get_dirname(writer->path);
+        g_mkdir_with_parents(dir, 0700);
+        g_free(dir);
+
+        if (writer->fd >= 0) {
+            close(writer->fd);
+            writer->fd = -1;
+        }
+        if (!g_file_set_contents(writer->path, (const gchar *)job->data->data, job->data->len, &error)) {
+            g_warning("Usage: failed to write %s: %s", writer->path, error->message);
+            g_error_free(error);
+        }
+    } else {
+        if (writer->fd < 0)
+            writer->fd = open(writer->path, O_WRONLY | O_APPEND | O_CLOEXEC);
+        /* One write per record, a crash leaves at most a truncated tail */
+        if (writer->fd < 0 || write(writer->fd, job->data->data, job->data->len) != (gssize)job->data->len)
+            g_warning("Usage: failed to append to %s: %s", writer->path, g_strerror(errno));
+    }
+
+    g_byte_array_unref(job->data);
+    g_free(job);
+}
+
+static void queue_log_job(LogJobType type, GByteArray *data) {
+    LogJob *job = g_new0(LogJob, 1);
+
+    job->type = type;
+    job->data = data;
+    g_thread_pool_push(usage_log_pool, job, NULL);
+}
+
+/* Replace the log with one record per app, the scores decayed to now */
+static void compact_log(LauncherPlugin *launcher) {
+    GByteArray *data = new_log_data();
+    GHashTableIter iter;
+    gpointer key;
+    Frecency *entry;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+
+    g_hash_table_iter_init(&iter, launcher->frecency);
+    while (g_hash_table_iter_next(&iter, &key, (gpointer *)&entry)) {
+        gdouble score = decay(entry->score, entry->time, now);
+
+        if (score < FRECENCY_MIN_SCORE) {
+            g_hash_table_iter_remove(&iter);
+            continue;
+        }
+        append_record(data, key, score, now);
+    }
+
+    usage_log_records = g_hash_table_size(launcher->frecency);
+    queue_log_job(LOG_REPLACE, data);
+}
+
+/*
+ * Parse the log, a truncated last record is ignored; returns the number
+ * of records. complete is FALSE when bytes were left over, appends after
+ * them would be lost to every later load.
+ */
+static guint load_log(LauncherPlugin *launcher, const gchar *contents, gsize length, gboolean *complete) {
+    gsize pos = LOG_HEADER_SIZE;
+    guint32 version;
+    guint records = 0;
+
+    *complete = FALSE;
+    if (length < LOG_HEADER_SIZE || memcmp(contents, LOG_MAGIC, 4) != 0)
+        return 0;
+    memcpy(&version, contents + 4, 4);
+    if (version != LOG_VERSION)
+        return 0;
+
+    while (pos + RECORD_HEADER_SIZE <= length) {
+        gint64 time;
+        gdouble weight;
+        guint32 id_len;
+        gchar *id;
+
+        memcpy(&time, contents + pos, 8);
+        memcpy(&weight, contents + pos + 8, 8);
+        memcpy(&id_len, contents + pos + 16, 4);
+        if (id_len > length - pos - RECORD_HEADER_SIZE)
+            break;
+
+        id = g_strndup(contents + pos + RECORD_HEADER_SIZE, id_len);
+        add_score(launcher, id, weight, time);
+        g_free(id);
+
+        pos += RECORD_HEADER_SIZE + id_len;
+        records++;
+    }
+
+    *complete = pos == length;
+    return records;
+}
+
+/* Counts kept by earlier versions become scores as of now */
+static void import_launch_counts(LauncherPlugin *launcher) {
+    gchar *path = g_build_filename(g_get_user_data_dir(), "xfce4", "launcher", "usage.ini", NULL);
+    GKeyFile *keyfile = g_key_file_new();
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    gchar **keys;
+    guint i;
+
+    if (g_key_file_load_from_file(keyfile, path, G_KEY_FILE_NONE, NULL)) {
+        keys = g_key_file_get_keys(keyfile, "Launches", NULL, NULL);
+        for (i = 0; keys && keys[i]; i++)
+            add_score(launcher, keys[i], g_key_file_get_integer(keyfile, "Launches", keys[i], NULL), now);
+        g_strfreev(keys);
+        g_unlink(path);
+    }
+
+    g_key_file_free(keyfile);
+    g_free(path);
+}
+
+/* Subscribe a launcher, the first one loads the log and starts the writer */
+void usage_init(LauncherPlugin *launcher) {
+    gint64 start = g_get_monotonic_time();
+    gchar *contents = NULL;
+    gsize length = 0;
+    gboolean complete = TRUE;
+
+    g_mutex_init(&launcher->prefetch_lock);
+    if (usage_users++ > 0) {
+        launcher->frecency = usage_frecency;
+        return;
+    }
+
+    usage_frecency = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    launcher->frecency = usage_frecency;
+
+    usage_writer = g_new0(LogWriter, 1);
+    usage_writer->path = get_log_path();
+    usage_writer->fd = -1;
+    usage_log_pool = g_thread_pool_new(write_log, usage_writer, 1, FALSE, NULL);
+
+    if (g_file_get_contents(usage_writer->path, &contents, &length, NULL)) {
+        usage_log_records = load_log(launcher, contents, length, &complete);
+        g_free(contents);
+    } else {
+        import_launch_counts(launcher);
+        compact_log(launcher);
+    }
+
+    g_debug("Usage: %u logged launches (%" G_GSIZE_FORMAT " KiB) for %u apps loaded in %.2f ms",
+            usage_log_records, length / 1024, g_hash_table_size(usage_frecency),
+            (g_get_monotonic_time() - start) / 1000.0);
+
+    /* A torn or unreadable log is rewritten from the records that parsed */
+    if (!complete || usage_log_records > g_hash_table_size(usage_frecency) + COMPACT_SLACK)
+        compact_log(launcher);
+}
+
+void usage_record_launch(LauncherPlugin *launcher, AppInfo *app_info) {
+    const gchar *id = app_info->id;
+    gint64 now = g_get_real_time() / G_USEC_PER_SEC;
+    GByteArray *data;
+
+    if (!id || !launcher->frecency)
+        return;
+
+    add_score(launcher, id, 1.0, now);
+
+    data = g_byte_array_new();
+    append_record(data, id, 1.0, now);
+    queue_log_job(LOG_APPEND, data);
+
+    if (++usage_log_records > g_hash_table_size(launcher->frecency) + COMPACT_SLACK)
+        compact_log(launcher);
+}
+
+/* Frecency of an app right now, 0 if it was never launched */
+gdouble usage_get_score(LauncherPlugin *launcher, AppInfo *app_info) {
+    const gchar *id;
+    Frecency *entry;
+
+    if (!launcher->frecency)
+        return 0.0;
+
+    id = app_info->id;
+    entry = id ? g_hash_table_lookup(launcher->frecency, id) : NULL;
+    if (!entry)
+        return 0.0;
+
+    return decay(entry->score, entry->time, g_get_real_time() / G_USEC_PER_SEC);
+}
+
+static gint compare_scores(gconstpointer a, gconstpointer b, gpointer data) {
+    GHashTable *scores = (GHashTable *)data;
+    gdouble score_a = *(gdouble *)g_hash_table_lookup(scores, a);
+    gdouble score_b = *(gdouble *)g_hash_table_lookup(scores, b);
+
+    return score_a < score_b ? 1 : score_a > score_b ? -1 : 0;
+}
+
+/* Order apps by frecency, apps with equal scores keep their order */
+GList* usage_rank(LauncherPlugin *launcher, GList *apps) {
+    GHashTable *scores;
+    gdouble *values;
+    GList *iter;
+    guint i, n = g_list_length(apps);
+
+    if (n < 2 || g_hash_table_size(launcher->frecency) == 0)
+        return apps;
+
+    /* Score every app once, not once per comparison */
+    scores = g_hash_table_new(g_direct_hash, g_direct_equal);
+    values = g_new(gdouble, n);
+    for (iter = apps, i = 0; iter != NULL; iter = g_list_next(iter), i++) {
+        values[i] = usage_get_score(launcher, iter->data);
+        g_hash_table_insert(scores, iter->data, &values[i]);
+    }
+
+    apps = g_list_sort_with_data(apps, compare_scores, scores);
+
+    g_hash_table_destroy(scores);
+    g_free(values);
+    return apps;
+}
+
+/* Apps for the "Frequent" page, most used first, at most max_apps */
+GList* usage_get_frequent(LauncherPlugin *launcher, gint max_apps) {
+    GList *frequent = NULL, *iter;
+
+    for (iter = launcher->app_list; iter != NULL; iter = g_list_next(iter)) {
+        AppInfo *app_info = (AppInfo *)iter->data;
+
+        if (app_info->name && !app_info->is_hidden &&
+            usage_get_score(launcher, app_info) >= FREQUENT_MIN_SCORE)
+            frequent = g_list_prepend(frequent, app_info);
+    }
+
+    frequent = usage_rank(launcher, g_list_reverse(frequent));
+    iter = g_list_nth(frequent, max_apps);
+    if (iter) {
+        iter->prev->next = NULL;
+        iter->prev = NULL;
+        g_list_free(iter);
+    }
+
+    return frequent;
+}
+
+/* Take size bytes from the budget of the job's opening, under the lock as the pool may run several threads */
+static gboolean take_prefetch_budget(LauncherPlugin *launcher, guint session, gint64 size) {
+    gboolean taken = FALSE;
+
+    g_mutex_lock(&launcher->prefetch_lock);
+    /* Threads may finish the jobs of two openings out of order, sessions only go forward */
+    if (session > launcher->prefetch_budget_session) {
+        launcher->prefetch_budget_session = session;
+        launcher->prefetch_budget = PREFETCH_BUDGET_BYTES;
+    }
+    if (size <= launcher->prefetch_budget) {
+        launcher->prefetch_budget -= size;
+        taken = TRUE;
+    }
+    g_mutex_unlock(&launcher->prefetch_lock);
+
+    return taken;
+}
+
+/* Runs on a prefetch thread */
+static void prefetch_file(gpointer data, gpointer user_data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)user_data;
+    PrefetchJob *job = (PrefetchJob *)data;
+    gint64 start = g_get_monotonic_time();
+    struct stat st;
+    gint fd;
+
+    fd = open(job->path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            take_prefetch_budget(launcher, job->session, st.st_size)) {
+#ifdef __linux__
+            readahead(fd, 0, st.st_size);
+#else
+            posix_fadvise(fd, 0, st.st_size, POSIX_FADV_WILLNEED);
+#endif
+            g_debug("Prefetch: %s, %" G_GINT64_FORMAT " KiB in %.2f ms", job->path,
+                    (gint64)st.st_size / 1024, (g_get_monotonic_time() - start) / 1000.0);
+        }
+        close(fd);
+    }
+
+    g_free(job->path);
+    g_free(job);
+}
+
+static void queue_prefetch(LauncherPlugin *launcher, gchar *path) {
+    PrefetchJob *job;
+    gint64 now = g_get_monotonic_time();
+    gint64 *last;
+
+    if (!path)
+        return;
+
+    last = g_hash_table_lookup(launcher->prefetched, path);
+    if (last && now - *last < PREFETCH_REPEAT_US) {
+        g_free(path);
+        return;
+    }
+
+    last = g_new(gint64, 1);
+    *last = now;
+    g_hash_table_insert(launcher->prefetched, g_strdup(path), last);
+
+    job = g_new0(PrefetchJob, 1);
+    job->path = path;
+    job->session = launcher->prefetch_session;
+    g_thread_pool_push(launcher->prefetch_pool, job, NULL);
+}
+
+/* The executable an application starts, and the one its TryExec names */
+static void prefetch_app(LauncherPlugin *launcher, AppInfo *app_info) {
+    GDesktopAppInfo *desktop_info = app_info_get_desktop_info(app_info);
+    const gchar *commandline = app_info->exec;
+    gchar *try_exec = desktop_info ? g_desktop_app_info_get_string(desktop_info, "TryExec") : NULL;
+    gchar **argv;
+
+    if (commandline && g_shell_parse_argv(commandline, NULL, &argv, NULL)) {
+        queue_prefetch(launcher, g_find_program_in_path(argv[0]));
+        g_strfreev(argv);
+    }
+    if (try_exec) {
+        queue_prefetch(launcher, g_find_program_in_path(try_exec));
+        g_free(try_exec);
+    }
+}
+
+/* A new opening of the overlay gets a fresh readahead budget */
+void usage_prefetch_begin(LauncherPlugin *launcher) {
+    launcher->prefetch_session++;
+}
+
+/*
+ * Read ahead the binaries of the most launched apps on the page shown,
+ * which in search mode are the top results. Cold starts of large apps
+ * are dominated by disk reads, done here while the user is still looking.
+ */
+void usage_prefetch_candidates(LauncherPlugin *launcher) {
+    GList *candidates = NULL, *iter;
+    GridItem *items;
+    gint count, i;
+
+    if (!launcher->prefetch || !launcher->overlay_window ||
+        !gtk_widget_get_visible(launcher->overlay_window) ||
+        g_hash_table_size(launcher->frecency) == 0)
+        return;
+
+    if (!launcher->prefetch_pool) {
+        launcher->prefetch_pool = g_thread_pool_new(prefetch_file, launcher, launcher->worker_threads, FALSE, NULL);
+        launcher->prefetched = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    }
+
+    items = page_index_get_page(launcher, launcher->current_page, &count);
+    for (i = count - 1; i >= 0; i--) {
+        if (items[i].app_info && usage_get_score(launcher, items[i].app_info) > 0.0)
+            candidates = g_list_prepend(candidates, items[i].app_info);
+    }
+
+    candidates = usage_rank(launcher, candidates);
+    for (iter = candidates, i = 0; iter != NULL && i < PREFETCH_CANDIDATES; iter = g_list_next(iter), i++)
+        prefetch_app(launcher, iter->data);
+
+    g_list_free(candidates);
+}
+
+/* Readahead threads, the log writer stays alone to keep its appends in order */
+void usage_set_worker_threads(LauncherPlugin *launcher, guint threads) {
+    launcher->worker_threads = threads;
+    if (launcher->prefetch_pool)
+        g_thread_pool_set_max_threads(launcher->prefetch_pool, threads, NULL);
+}
+
+void usage_free(LauncherPlugin *launcher) {
+    /* Pending reads are dropped, the one running is waited for */
+    if (launcher->prefetch_pool) {
+        g_thread_pool_free(launcher->prefetch_pool, TRUE, TRUE);
+        launcher->prefetch_pool = NULL;
+    }
+    g_clear_pointer(&launcher->prefetched, g_hash_table_destroy);
+    g_mutex_clear(&launcher->prefetch_lock);
+
+    if (!launcher->frecency)
+        return;
+    launcher->frecency = NULL;
+    if (--usage_users > 0)
+        return;
+
+    /* Every queued launch still reaches the log */
+    g_thread_pool_free(usage_log_pool, FALSE, TRUE);
+    usage_log_pool = NULL;
+    if (usage_writer->fd >= 0)
+        close(usage_writer->fd);
+    g_free(usage_writer->path);
+    g_clear_pointer(&usage_writer, g_free);
+    g_clear_pointer(&usage_frecency, g_hash_table_destroy);
+}
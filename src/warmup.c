@@ -0,0 +1,143 @@
+/*
+ * Speculative warm-up of the overlay for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+#include "xfce-launcher.h"
+
+/* Hover time before warming up, filters out a pointer passing over the panel */
+#define WARMUP_DELAY_MS 60
+/* Icons decoded per idle step */
+#define WARMUP_ICONS_PER_STEP 6
+
+enum {
+    WARMUP_STEP_REALIZE,
+    WARMUP_STEP_PAGE,
+    WARMUP_STEP_ICONS,
+    WARMUP_STEP_DONE
+};
+
+static void warm_icon(LauncherPlugin *launcher, const gchar *icon_name) {
+    GtkIconTheme *icon_theme;
+    GdkPixbuf *pixbuf;
+
+    if (launcher->drawn_grid) {
+        tile_grid_preload_icon(launcher->app_grid, icon_name);
+        return;
+    }
+
+    /* The widget grid loads through GtkImage, reading the file pulls it into the page cache */
+    icon_theme = gtk_icon_theme_get_default();
+    pixbuf = gtk_icon_theme_load_icon(icon_theme, icon_name ? icon_name : "application-x-executable",
+                                      launcher->layout.icon_size, GTK_ICON_LOOKUP_FORCE_SIZE, NULL);
+    if (pixbuf)
+        g_object_unref(pixbuf);
+}
+
+static gboolean warmup_step(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+    GridItem *items;
+    gint count, end;
+
+    switch (launcher->warmup_step) {
+        case WARMUP_STEP_REALIZE:
+            overlay_select(launcher, overlay_get_target_monitor(launcher));
+            gtk_widget_realize(launcher->overlay_window);
+            launcher->warmup_step = WARMUP_STEP_PAGE;
+            return G_SOURCE_CONTINUE;
+
+        case WARMUP_STEP_PAGE:
+            layout_update(launcher, overlay_get_monitor(launcher));
+            launcher->current_page = 0;
+            if (launcher->page_dirty || launcher->shown_page != 0) {
+                populate_current_page(launcher);
+                update_page_dots(launcher);
+            }
+            launcher->warmup_step = WARMUP_STEP_ICONS;
+            launcher->warmup_page = 0;
+            launcher->warmup_icon = 0;
+            return G_SOURCE_CONTINUE;
+
+        case WARMUP_STEP_ICONS:
+            /* The icons of the first pre-render depth pages, the first one is on screen at open */
+            items = page_index_get_page(launcher, launcher->warmup_page, &count);
+            end = MIN(launcher->warmup_icon + WARMUP_ICONS_PER_STEP, count);
+            for (; launcher->warmup_icon < end; launcher->warmup_icon++) {
+                GridItem *item = &items[launcher->warmup_icon];
+                warm_icon(launcher, item->folder_info ? item->folder_info->icon : item->app_info->icon);
+            }
+            if (launcher->warmup_icon < count)
+                return G_SOURCE_CONTINUE;
+            if (++launcher->warmup_page < (gint)launcher->prerender_depth &&
+                launcher->warmup_page < page_index_get_page_count(launcher)) {
+                launcher->warmup_icon = 0;
+                return G_SOURCE_CONTINUE;
+            }
+            launcher->warmup_step = WARMUP_STEP_DONE;
+            break;
+
+        default:
+            break;
+    }
+
+    launcher->warmup_source = 0;
+    launcher->warmup_ready = TRUE;
+    launcher->warmup_completed++;
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean warmup_begin(gpointer data) {
+    LauncherPlugin *launcher = (LauncherPlugin *)data;
+
+    launcher->warmup_started++;
+    launcher->warmup_step = WARMUP_STEP_REALIZE;
+    launcher->warmup_source = g_idle_add_full(G_PRIORITY_LOW, warmup_step, launcher, NULL);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean on_button_enter(GtkWidget *button, GdkEventCrossing *event, LauncherPlugin *launcher) {
+    /* A pre-render depth of 0 turns the warm-up off */
+    if (launcher->prerender_depth == 0 || launcher->warmup_source || launcher->warmup_ready || !launcher->overlay_window ||
+        gtk_widget_get_visible(launcher->overlay_window))
+        return FALSE;
+
+    launcher->warmup_source = g_timeout_add_full(G_PRIORITY_LOW, WARMUP_DELAY_MS,
+                                                 warmup_begin, launcher, NULL);
+    return FALSE;
+}
+
+static gboolean on_button_leave(GtkWidget *button, GdkEventCrossing *event, LauncherPlugin *launcher) {
+    /* Work already done is kept, only the remaining steps are dropped */
+    if (launcher->warmup_source) {
+        warmup_cancel(launcher);
+        launcher->warmup_cancelled++;
+    }
+    return FALSE;
+}
+
+void warmup_init(LauncherPlugin *launcher) {
+    gtk_widget_add_events(launcher->button, GDK_ENTER_NOTIFY_MASK | GDK_LEAVE_NOTIFY_MASK);
+    g_signal_connect(launcher->button, "enter-notify-event",
+                     G_CALLBACK(on_button_enter), launcher);
+    g_signal_connect(launcher->button, "leave-notify-event",
+                     G_CALLBACK(on_button_leave), launcher);
+}
+
+void warmup_cancel(LauncherPlugin *launcher) {
+    if (launcher->warmup_source) {
+        g_source_remove(launcher->warmup_source);
+        launcher->warmup_source = 0;
+    }
+}
+
+/* Account the warm-up for an opening overlay */
+void warmup_note_open(LauncherPlugin *launcher) {
+    if (launcher->warmup_ready)
+        launcher->warmup_used++;
+
+    warmup_cancel(launcher);
+    launcher->warmup_ready = FALSE;
+}
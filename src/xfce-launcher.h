@@ -26,16 +26,70 @@
 typedef struct _LauncherPlugin LauncherPlugin;
 typedef struct _AppInfo AppInfo;
 typedef struct _FolderInfo FolderInfo;
+typedef struct _OverlayInstance OverlayInstance;
+typedef struct _ParsedConfig ParsedConfig;
+
+/* Timing accumulator used by the performance instrumentation */
+typedef struct {
+    guint   count;
+    gint64  total_us;
+    gint64  max_us;
+} PerfCounter;
+
+/* Animation used when switching pages in the drawn grid */
+typedef enum {
+    PAGE_TRANSITION_NONE,
+    PAGE_TRANSITION_SLIDE,
+    PAGE_TRANSITION_FADE
+} PageTransition;
+
+/* How the search entry matches application names, see search.c */
+typedef enum {
+    SEARCH_BACKEND_LINEAR,
+    SEARCH_BACKEND_TRIGRAM,
+    SEARCH_BACKEND_FUZZY
+} SearchBackend;
+
+/* Grid geometry computed for a monitor, see layout.c */
+typedef struct {
+    gint columns;
+    gint rows;
+    gint apps_per_page;
+    gint button_size;
+    gint icon_size;
+    gint pitch;
+    gint scale;
+} GridLayout;
+
+/* Smooth scroll integration, one page change per gesture */
+typedef enum {
+    SCROLL_AXIS_NONE,
+    SCROLL_AXIS_X,
+    SCROLL_AXIS_Y
+} ScrollAxis;
+
+typedef struct {
+    gdouble     dx;
+    gdouble     dy;
+    ScrollAxis  axis;
+    gboolean    engaged;
+    gint64      last_time;
+    gint64      commit_frame;
+} ScrollAccumulator;
 
 /* Application info structure */
 struct _AppInfo {
     gchar *name;
     gchar *exec;
     gchar *icon;
-    GDesktopAppInfo *desktop_info;
+    gchar *id;
+    gchar *path;
+    GDesktopAppInfo *desktop_info;  /* Loaded on first use, see app_info_get_desktop_info */
     gboolean is_hidden;
     gchar *folder_id;
     gint position;
+    AppInfo *entry;                 /* Catalog entry a launcher's view borrows from */
+    gboolean mapped;                /* Strings point into the system catalog */
 };
 
 /* Folder structure */
@@ -47,26 +101,112 @@ struct _FolderInfo {
     gboolean is_open;
 };
 
+/* A single grid tile: either an application or a folder */
+typedef struct {
+    AppInfo    *app_info;
+    FolderInfo *folder_info;
+} GridItem;
+
 /* Plugin structure */
 struct _LauncherPlugin {
     XfcePanelPlugin *plugin;
     GtkWidget       *button;
     GtkWidget       *icon;
     GtkWidget       *overlay_window;
+    OverlayInstance *overlay;
+    GHashTable      *overlays;
+    GHashTable      *icon_tiers;
+    GObject         *memory_monitor;
     GtkWidget       *search_entry;
     GtkWidget       *app_grid;
+    GtkWidget       *grid_container;
+    gboolean        drawn_grid;
+    GridLayout      layout;
+    GHashTable      *layout_cache;
+    PageTransition  page_transition;
+    gdouble         swipe_start_x;
+    gboolean        swipe_tracking;
+    ScrollAccumulator scroll;
     GtkWidget       *page_dots;
     GtkWidget       *scrolled_window;
     GList           *app_list;
     GList           *filtered_list;
     GList           *folder_list;
+    GArray          *page_items;
+    GArray          *page_starts;
+    gboolean        page_index_valid;
+    GArray          *build_items;
+    gint            build_next;
+    guint           build_source;
     FolderInfo      *open_folder;
     GtkWidget       *back_button;
     gint            current_page;
     gint            total_pages;
+    gint            selected_index;
     gboolean        drag_mode;
     AppInfo         *drag_source;
     XfconfChannel   *channel;
+    gboolean        hot_standby;
+    gboolean        page_dirty;
+    gint            shown_page;
+    guint           standby_source;
+    guint           standby_hits;
+    guint           standby_misses;
+    guint           warmup_source;
+    gint            warmup_step;
+    gint            warmup_icon;
+    gboolean        warmup_ready;
+    guint           warmup_started;
+    guint           warmup_completed;
+    guint           warmup_cancelled;
+    guint           warmup_used;
+    gint            warmup_page;
+    guint           prerender_depth;
+    guint           icon_cache_mb;
+    guint           monitor_debounce;
+    SearchBackend   search_backend;
+    gpointer        search_index;
+    guint           worker_threads;
+    gboolean        tracing;
+    PerfCounter     frame_time;
+    PerfCounter     tile_draw_time;
+    PerfCounter     label_shape_time;
+    PerfCounter     open_latency;
+    PerfCounter     search_time;
+    PerfCounter     launch_latency;
+    gint64          frame_start;
+    gint64          open_time;
+    gint64          launch_time;
+    GCancellable    *launch_cancellable;
+    GSubprocess     *spawn_helper;
+    gint            spawn_fd;
+    guint           spawn_watch;
+    GQueue          *spawn_pending;
+    gboolean        launch_probe;
+    GQueue          *probe_pending;
+    GHashTable      *probe_clients;
+    guint           probe_sweep_source;
+    GHashTable      *frecency;      /* Shared by the launchers of the process, see usage.c */
+    gboolean        frequent_page;
+    gint            frequent_count;
+    gboolean        prefetch;
+    GThreadPool     *prefetch_pool;
+    GHashTable      *prefetched;
+    guint           prefetch_session;
+    GMutex          prefetch_lock;
+    guint           prefetch_budget_session;
+    gint64          prefetch_budget;
+    guint           config_save_source;
+    guint           config_save_requests;
+    GThreadPool     *config_pool;
+    GMutex          config_lock;
+    PerfCounter     config_snapshot_time;
+    PerfCounter     config_write_time;
+    guint           config_write_failures;
+    PerfCounter     config_journal_time;
+    gchar           *config_path;
+    gchar           *journal_path;
+    guint           journal_ops;
 };
 
 /* Helper structure for callbacks */
@@ -75,37 +215,169 @@ typedef struct {
     LauncherPlugin *launcher;
 } HideCallbackData;
 
-/* Constants */
-#define APPS_PER_PAGE 30
-#define GRID_COLUMNS 6
-#define GRID_ROWS 5
-#define ICON_SIZE 64
-#define BUTTON_SIZE 130
+/* Constants, tile and grid sizes come from the monitor layout */
+#define TILE_MARGIN 10
+#define TILE_SPACING 20
 
 /* Application management functions */
 GList* load_applications(void);
-GList* load_applications_enhanced(void);
-void setup_application_monitoring(LauncherPlugin *launcher);
+GList* load_applications_enhanced(GMappedFile **system_catalog);
+GPtrArray* setup_application_monitoring(void);
+void refresh_applications(LauncherPlugin *launcher);
 void free_app_info(AppInfo *app_info);
+GDesktopAppInfo* app_info_get_desktop_info(AppInfo *app_info);
 gint compare_app_names(gconstpointer a, gconstpointer b);
+gint compare_app_positions(gconstpointer a, gconstpointer b);
 void launch_application(GtkWidget *button, AppInfo *app_info);
+void notify_launch_error(const gchar *name, const gchar *message);
 void hide_application(AppInfo *app_info, LauncherPlugin *launcher);
 void recalculate_positions(LauncherPlugin *launcher);
+void move_application(LauncherPlugin *launcher, AppInfo *app, AppInfo *anchor, gboolean after);
 
 /* UI functions */
 void create_overlay_window(LauncherPlugin *launcher);
+void create_app_grid(LauncherPlugin *launcher);
 void hide_overlay(LauncherPlugin *launcher);
 void populate_current_page(LauncherPlugin *launcher);
+void page_build_cancel(LauncherPlugin *launcher);
 void update_page_dots(LauncherPlugin *launcher);
+void show_page(LauncherPlugin *launcher, gint page);
+void schedule_standby_rebuild(LauncherPlugin *launcher);
+void invalidate_page_index(LauncherPlugin *launcher);
+GridItem* page_index_get_page(LauncherPlugin *launcher, gint page, gint *count);
+gint page_index_get_page_count(LauncherPlugin *launcher);
+gint page_index_get_page_start(LauncherPlugin *launcher, gint page);
+gint page_index_get_item_count(LauncherPlugin *launcher);
+gint page_index_find_page(LauncherPlugin *launcher, gint index);
+gint page_index_find_item(LauncherPlugin *launcher, AppInfo *app_info);
+GridItem* page_index_get_item(LauncherPlugin *launcher, gint index);
+void page_index_move_item(LauncherPlugin *launcher, gint from, gint to);
+void refresh_page_tiles(LauncherPlugin *launcher, gint first, gint last);
+void page_index_free(LauncherPlugin *launcher);
 const gchar* get_css_style(void);
 
+/* Custom drawn grid */
+GtkWidget* tile_grid_new(LauncherPlugin *launcher);
+void tile_grid_set_items(GtkWidget *widget, const GridItem *items, gint count);
+void tile_grid_update_items(GtkWidget *widget, gint first, const GridItem *items, gint count);
+gboolean tile_grid_hit_test(GtkWidget *widget, gint x, gint y, GridItem *item);
+void tile_grid_preload_icon(GtkWidget *widget, const gchar *icon_name);
+void tile_grid_layout_changed(GtkWidget *widget);
+void tile_grid_begin_transition(GtkWidget *widget, gint direction);
+void tile_grid_swipe_update(GtkWidget *widget, gdouble offset);
+gint tile_grid_swipe_end(GtkWidget *widget, gdouble velocity);
+void tile_grid_swipe_cancel(GtkWidget *widget);
+void tile_grid_set_selection(GtkWidget *widget, gint index);
+gint tile_grid_get_selection(GtkWidget *widget);
+gint tile_grid_get_item_count(GtkWidget *widget);
+const gchar* tile_grid_get_item_name(GtkWidget *widget, gint index);
+void tile_grid_get_tile_rect(GtkWidget *widget, gint index, GdkRectangle *rect);
+void tile_grid_focus_tile(GtkWidget *widget, gint index);
+void tile_grid_activate(GtkWidget *widget, gint index);
+
+/* Accessibility of the drawn grid, a child per tile */
+GType tile_grid_accessible_get_type(void);
+void tile_grid_accessible_items_changed(GtkWidget *widget, gint count);
+void tile_grid_accessible_names_changed(GtkWidget *widget, gint first, gint count);
+void tile_grid_accessible_selection_changed(GtkWidget *widget, gint old_index, gint index);
+
+/* Icon theme browser, func gets the icon picked and whether it was activated */
+typedef void (*IconBrowserFunc)(const gchar *icon_name, gboolean activated, gpointer data);
+GtkWidget* icon_browser_new(IconBrowserFunc func, gpointer data);
+void icon_browser_set_filter(GtkWidget *widget, const gchar *text);
+void icon_browser_select(GtkWidget *widget, const gchar *icon_name);
+
+/* Theme */
+gchar* get_user_theme_path(void);
+void theme_acquire(void);
+void theme_release(void);
+void theme_apply(GtkWidget *widget);
+void theme_apply_context(GtkStyleContext *context);
+void theme_apply_button(GtkWidget *button);
+
+/* Per-monitor overlays */
+GdkMonitor* overlay_get_target_monitor(LauncherPlugin *launcher);
+GdkMonitor* overlay_get_monitor(LauncherPlugin *launcher);
+void overlay_select(LauncherPlugin *launcher, GdkMonitor *monitor);
+void overlay_fullscreen(LauncherPlugin *launcher);
+GHashTable* overlay_get_icon_tier(LauncherPlugin *launcher, gint scale, gint icon_size);
+void overlay_invalidate_all(LauncherPlugin *launcher);
+void overlay_free(LauncherPlugin *launcher);
+
+/* Grid layout */
+GdkMonitor* layout_get_monitor(LauncherPlugin *launcher);
+gboolean layout_update(LauncherPlugin *launcher, GdkMonitor *monitor);
+void layout_free(LauncherPlugin *launcher);
+
+/* Scroll input */
+void scroll_accumulator_reset(ScrollAccumulator *acc);
+gint scroll_accumulator_feed(ScrollAccumulator *acc, gdouble delta_x, gdouble delta_y,
+                             gint64 time, gboolean is_stop);
+gboolean scroll_accumulator_claim_frame(ScrollAccumulator *acc, gint64 frame);
+
+/* Spawn helper */
+void spawn_helper_start(LauncherPlugin *launcher);
+void spawn_helper_stop(LauncherPlugin *launcher);
+gboolean spawn_helper_launch(LauncherPlugin *launcher, GDesktopAppInfo *info, const gchar *app_id,
+                             GAppLaunchContext *context);
+
+/* Launch latency probe */
+void probe_init(LauncherPlugin *launcher);
+void probe_set_enabled(LauncherPlugin *launcher, gboolean enabled);
+void probe_launch_started(LauncherPlugin *launcher, const gchar *app_id, const gchar *startup_id,
+                          GPid pid, gint64 start);
+void probe_show_diagnostics(LauncherPlugin *launcher, GtkWindow *parent);
+void probe_free(LauncherPlugin *launcher);
+
+/* Process-wide application catalog */
+void catalog_acquire(LauncherPlugin *launcher);
+void catalog_release(LauncherPlugin *launcher);
+void catalog_schedule_reload(void);
+GList* catalog_new_view(void);
+GHashTable* catalog_acquire_icon_tier(gpointer key);
+void catalog_release_icon_tier(gpointer key);
+void catalog_clear_icons(void);
+void catalog_insert_icon(gpointer key, const gchar *name, cairo_surface_t *surface);
+void catalog_set_icon_cache_limit(gsize bytes);
+void catalog_set_reload_delay(guint delay_ms);
+
+/* Launch statistics and readahead */
+void usage_init(LauncherPlugin *launcher);
+void usage_record_launch(LauncherPlugin *launcher, AppInfo *app_info);
+gdouble usage_get_score(LauncherPlugin *launcher, AppInfo *app_info);
+GList* usage_rank(LauncherPlugin *launcher, GList *apps);
+GList* usage_get_frequent(LauncherPlugin *launcher, gint max_apps);
+void usage_prefetch_begin(LauncherPlugin *launcher);
+void usage_prefetch_candidates(LauncherPlugin *launcher);
+void usage_set_worker_threads(LauncherPlugin *launcher, guint threads);
+void usage_free(LauncherPlugin *launcher);
+
+/* Search backends */
+GList* search_applications(LauncherPlugin *launcher, const gchar *text);
+void search_invalidate(LauncherPlugin *launcher);
+void search_free(LauncherPlugin *launcher);
+
+/* Keyboard navigation */
+void selection_set(LauncherPlugin *launcher, gint index);
+void selection_show(LauncherPlugin *launcher);
+gboolean navigation_handle_key(LauncherPlugin *launcher, GdkEventKey *event);
+
+/* Speculative warm-up */
+void warmup_init(LauncherPlugin *launcher);
+void warmup_cancel(LauncherPlugin *launcher);
+void warmup_note_open(LauncherPlugin *launcher);
+
 /* Event handlers */
 gboolean on_key_press(GtkWidget *widget, GdkEventKey *event, LauncherPlugin *launcher);
 void on_search_changed(GtkSearchEntry *entry, LauncherPlugin *launcher);
 void on_dot_clicked(GtkWidget *dot, gpointer data);
 gboolean on_scroll_event(GtkWidget *widget, GdkEventScroll *event, LauncherPlugin *launcher);
+void on_swipe_begin(GtkGesture *gesture, GdkEventSequence *sequence, LauncherPlugin *launcher);
+void on_swipe_update(GtkGesture *gesture, GdkEventSequence *sequence, LauncherPlugin *launcher);
+void on_swipe_cancel(GtkGesture *gesture, GdkEventSequence *sequence, LauncherPlugin *launcher);
 void on_swipe_gesture(GtkGestureSwipe *gesture, gdouble velocity_x, gdouble velocity_y, LauncherPlugin *launcher);
 gboolean on_button_press_event(GtkWidget *widget, GdkEventButton *event, AppInfo *app_info);
+gboolean on_folder_button_press_event(GtkWidget *widget, GdkEventButton *event, FolderInfo *folder_info);
 void on_folder_clicked(GtkWidget *button, FolderInfo *folder_info);
 void on_back_button_clicked(GtkWidget *button, LauncherPlugin *launcher);
 
@@ -123,11 +395,35 @@ void free_folder_info(FolderInfo *folder_info);
 FolderInfo* find_folder_by_id(LauncherPlugin *launcher, const gchar *folder_id);
 void add_app_to_folder(LauncherPlugin *launcher, AppInfo *app, const gchar *folder_id);
 void remove_app_from_folder(LauncherPlugin *launcher, AppInfo *app);
+void rename_folder(LauncherPlugin *launcher, FolderInfo *folder, const gchar *name);
+void delete_folder(LauncherPlugin *launcher, FolderInfo *folder);
+void folders_join_apps(LauncherPlugin *launcher);
 
 /* Configuration */
-gchar* get_config_file_path(void);
+gchar* get_config_file_path(gint unique_id);
 void save_configuration(LauncherPlugin *launcher);
 void load_configuration(LauncherPlugin *launcher);
+ParsedConfig* parse_configuration(const gchar *snapshot_path, const gchar *journal_path);
+void apply_configuration(LauncherPlugin *launcher, ParsedConfig *config);
+GThread* load_configuration_begin(LauncherPlugin *launcher);
+void load_configuration_finish(LauncherPlugin *launcher, GThread *parser);
+void flush_configuration(LauncherPlugin *launcher);
+gchar* get_journal_file_path(gint unique_id);
+void journal_record_hide(LauncherPlugin *launcher, AppInfo *app);
+void journal_record_position(LauncherPlugin *launcher, AppInfo *app);
+void journal_record_folder_add(LauncherPlugin *launcher, FolderInfo *folder);
+void journal_record_folder_app(LauncherPlugin *launcher, AppInfo *app);
+void journal_record_folder_rename(LauncherPlugin *launcher, FolderInfo *folder);
+void journal_record_folder_remove(LauncherPlugin *launcher, FolderInfo *folder);
+
+/* Performance instrumentation */
+void perf_counter_add(PerfCounter *counter, gint64 usec);
+void perf_counter_reset(PerfCounter *counter);
+void perf_counter_report(const PerfCounter *counter, const gchar *label);
+void perf_watch_frames(LauncherPlugin *launcher, GtkWidget *window);
+void perf_report_overlay(LauncherPlugin *launcher);
+void perf_report_configuration(LauncherPlugin *launcher);
+void perf_set_tracing(LauncherPlugin *launcher, gboolean tracing);
 
 /* Plugin lifecycle callbacks */
 void launcher_button_clicked(GtkWidget *button, LauncherPlugin *launcher);
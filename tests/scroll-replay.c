@@ -0,0 +1,116 @@
+/*
+ * Scroll accumulator replay for XFCE Launcher
+ *
+ * Copyright (C) 2025 Kamil 'Novik' Nowicki
+ *
+ * Author: Kamil 'Novik' Nowicki <novik@axisos.org>
+ */
+
+/*
+ * Feeds recorded smooth scroll streams to scroll_accumulator_feed() and
+ * checks the page steps it returns. Times are the millisecond event times
+ * GDK delivers, scaled the way on_scroll_event() does. Run by "make check".
+ */
+
+#include "../src/xfce-launcher.h"
+#include <stdio.h>
+
+#define MAX_STEPS 4
+
+typedef struct {
+    gdouble  delta_x;
+    gdouble  delta_y;
+    guint32  time;
+    gboolean is_stop;
+} ScrollSample;
+
+typedef struct {
+    const gchar        *name;
+    const ScrollSample *samples;
+    gint                n_samples;
+    gint                steps[MAX_STEPS];
+    gint                n_steps;
+} ScrollRecording;
+
+/* Touchpad flick down, two fingers lifted at the end */
+static const ScrollSample touchpad_flick[] = {
+    { 0.00, 0.21, 1000, FALSE }, { 0.01, 0.48, 1008, FALSE }, { 0.00, 0.93, 1016, FALSE },
+    { 0.02, 1.44, 1024, FALSE }, { 0.00, 1.12, 1032, FALSE }, { 0.00, 0.61, 1040, FALSE },
+    { 0.00, 0.27, 1048, FALSE }, { 0.00, 0.00, 1056, TRUE  },
+};
+
+/* The same flick upwards with kinetic events trailing after the stop */
+static const ScrollSample touchpad_flick_back[] = {
+    { 0.00, -0.35, 2000, FALSE }, { 0.00, -0.82, 2008, FALSE }, { 0.00, -1.20, 2016, FALSE },
+    { 0.00,  0.00, 2024, TRUE  }, { 0.00, -0.40, 2032, FALSE }, { 0.00, -0.18, 2040, FALSE },
+};
+
+/* Resting fingers, too little travel for a page */
+static const ScrollSample touchpad_nudge[] = {
+    { 0.00, 0.12, 3000, FALSE }, { 0.00, 0.30, 3008, FALSE }, { 0.00, 0.25, 3016, FALSE },
+    { 0.00, 0.00, 3024, TRUE  },
+};
+
+/* Sideways swipe that starts with diagonal jitter */
+static const ScrollSample diagonal_swipe[] = {
+    { 0.04, 0.06, 4000, FALSE }, { 0.55, 0.09, 4008, FALSE }, { 0.70, 0.20, 4016, FALSE },
+    { 0.90, 0.35, 4024, FALSE }, { 0.00, 0.00, 4032, TRUE  },
+};
+
+/* Direction reversed mid-gesture, still one page */
+static const ScrollSample reversed_flick[] = {
+    { 0.00,  0.60, 5000, FALSE }, { 0.00,  0.70, 5008, FALSE }, { 0.00, -0.90, 5016, FALSE },
+    { 0.00, -1.30, 5024, FALSE }, { 0.00, -1.10, 5032, FALSE }, { 0.00,  0.00, 5040, TRUE  },
+};
+
+/* Smooth wheel without stop events, the pauses between notches end the gestures */
+static const ScrollSample wheel_notches[] = {
+    { 0.00, 1.00, 6000, FALSE }, { 0.00, 1.00, 6300, FALSE }, { 0.00, 1.00, 6360, FALSE },
+    { 0.00, 1.00, 6700, FALSE },
+};
+
+static const ScrollRecording recordings[] = {
+    { "touchpad flick",      touchpad_flick,      G_N_ELEMENTS(touchpad_flick),      { 1 },       1 },
+    { "touchpad flick back", touchpad_flick_back, G_N_ELEMENTS(touchpad_flick_back), { -1 },      1 },
+    { "touchpad nudge",      touchpad_nudge,      G_N_ELEMENTS(touchpad_nudge),      { 0 },       0 },
+    { "diagonal swipe",      diagonal_swipe,      G_N_ELEMENTS(diagonal_swipe),      { 1 },       1 },
+    { "reversed flick",      reversed_flick,      G_N_ELEMENTS(reversed_flick),      { 1 },       1 },
+    { "wheel notches",       wheel_notches,       G_N_ELEMENTS(wheel_notches),       { 1, 1, 1 }, 3 },
+};
+
+static gboolean replay(const ScrollRecording *recording) {
+    ScrollAccumulator acc = { 0 };
+    gint steps[MAX_STEPS];
+    gint n_steps = 0, i;
+    gboolean passed;
+
+    scroll_accumulator_reset(&acc);
+    for (i = 0; i < recording->n_samples; i++) {
+        const ScrollSample *sample = &recording->samples[i];
+        gint step = scroll_accumulator_feed(&acc, sample->delta_x, sample->delta_y,
+                                            (gint64)sample->time * 1000, sample->is_stop);
+
+        if (step != 0 && n_steps < MAX_STEPS)
+            steps[n_steps++] = step;
+    }
+
+    passed = n_steps == recording->n_steps;
+    for (i = 0; passed && i < n_steps; i++)
+        passed = steps[i] == recording->steps[i];
+
+    printf("%s: %s (%d page steps, expected %d)\n", passed ? "PASS" : "FAIL",
+           recording->name, n_steps, recording->n_steps);
+    return passed;
+}
+
+int main(void) {
+    gint failed = 0;
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS(recordings); i++) {
+        if (!replay(&recordings[i]))
+            failed++;
+    }
+
+    return failed == 0 ? 0 : 1;
+}
@@ -85,12 +85,15 @@ function remove_plugin() {
         print_info "Removing from system directory (sudo required)"
     fi
     
-    # Remove library file
+    # Remove library file and the spawn helper next to it
     if [ -n "$lib_file" ] && [ -f "$lib_file" ]; then
+        local helper_file="$(dirname "$lib_file")/xfce-launcher-spawn"
         if $use_sudo; then
             sudo rm -v "$lib_file"
+            [ -f "$helper_file" ] && sudo rm -v "$helper_file"
         else
             rm -v "$lib_file"
+            [ -f "$helper_file" ] && rm -v "$helper_file"
         fi
     fi
     